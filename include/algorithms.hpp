@@ -1,4 +1,6 @@
 #include "math/Vector3.hpp"
+#include <cmath>
+#include <cstdint>
 #include <vector>
 
 /**
@@ -100,6 +102,200 @@ std::vector<std::pair<int, int>> bresenham(int x0, int y0, int x1, int y1) {
   }
 }
 
+/**
+ * The edge function of a directed 2D line, in the form \f$E(x, y) = ax + by +
+ * c\f$, as used by Pineda-style triangle rasterizers.
+ *
+ * The edge function is positive for points to the left of the line (when going
+ * from the first point to the second point in a Y-up coordinate system),
+ * negative for points to the right, and zero for points on the line. Since the
+ * function is linear, it can be evaluated incrementally: stepping one unit
+ * along the x axis adds \f$a\f$, and stepping one unit along the y axis adds
+ * \f$b\f$.
+ */
+struct EdgeFunction {
+  double a; /**< The coefficient of x. */
+  double b; /**< The coefficient of y. */
+  double c; /**< The constant term. */
+
+  /**
+   * Creates the edge function of the line going from \f$(x_0, y_0)\f$ to
+   * \f$(x_1, y_1)\f$.
+   *
+   * @param x0 The x-coordinate of the first point.
+   * @param y0 The y-coordinate of the first point.
+   * @param x1 The x-coordinate of the second point.
+   * @param y1 The y-coordinate of the second point.
+   */
+  EdgeFunction(double x0, double y0, double x1, double y1)
+      : a(y0 - y1), b(x1 - x0), c(x0 * y1 - x1 * y0) {}
+
+  /**
+   * Evaluates this edge function at the specified point.
+   *
+   * @param x The x-coordinate of the point.
+   * @param y The y-coordinate of the point.
+   * @returns Twice the signed area of the triangle formed by the line and the
+   * point.
+   */
+  double operator()(double x, double y) const { return a * x + b * y + c; }
+
+  /**
+   * Flips the sign of this edge function, so that points to the right of the
+   * line become positive.
+   *
+   * @returns This edge function.
+   */
+  EdgeFunction &negate() {
+    a = -a;
+    b = -b;
+    c = -c;
+
+    return *this;
+  }
+};
+
+/**
+ * The number of fractional bits of fixed-point sub-pixel coordinates.
+ */
+constexpr int subpixelBits = 8;
+
+/**
+ * Snaps a screen-space coordinate to a fixed-point sub-pixel coordinate with
+ * {@link #subpixelBits} fractional bits.
+ *
+ * @param value The coordinate in pixels.
+ * @returns The coordinate in sub-pixels.
+ */
+inline std::int64_t toSubpixel(double value) {
+  return std::llround(value * (1 << subpixelBits));
+}
+
+/**
+ * The {@link EdgeFunction} of a directed 2D line between two points with
+ * fixed-point sub-pixel coordinates.
+ *
+ * The edge function is evaluated exactly with integer arithmetic, so the edge
+ * functions of an edge shared by two triangles are exact opposites, and the
+ * coverage of a pixel does not depend on the order of the operations.
+ */
+struct FixedPointEdgeFunction {
+  std::int64_t a; /**< The coefficient of x, in sub-pixels. */
+  std::int64_t b; /**< The coefficient of y, in sub-pixels. */
+  std::int64_t c; /**< The constant term, in square sub-pixels. */
+
+  /**
+   * Creates the edge function of the line going from \f$(x_0, y_0)\f$ to
+   * \f$(x_1, y_1)\f$, in sub-pixels.
+   *
+   * @param x0 The x-coordinate of the first point.
+   * @param y0 The y-coordinate of the first point.
+   * @param x1 The x-coordinate of the second point.
+   * @param y1 The y-coordinate of the second point.
+   */
+  FixedPointEdgeFunction(std::int64_t x0, std::int64_t y0, std::int64_t x1,
+                         std::int64_t y1)
+      : a(y0 - y1), b(x1 - x0), c(x0 * y1 - x1 * y0) {}
+
+  /**
+   * Evaluates this edge function at the center of the specified pixel.
+   *
+   * @param x The x-coordinate of the pixel.
+   * @param y The y-coordinate of the pixel.
+   * @returns Twice the signed area of the triangle formed by the line and the
+   * pixel's center, in square sub-pixels.
+   */
+  std::int64_t operator()(int x, int y) const {
+    return a * (std::int64_t{x} << subpixelBits) +
+           b * (std::int64_t{y} << subpixelBits) + c;
+  }
+
+  /**
+   * Returns the increment of this edge function from one pixel to the next
+   * along the x axis.
+   */
+  std::int64_t stepX() const { return a << subpixelBits; }
+
+  /**
+   * Flips the sign of this edge function, so that points to the right of the
+   * line become positive.
+   *
+   * @returns This edge function.
+   */
+  FixedPointEdgeFunction &negate() {
+    a = -a;
+    b = -b;
+    c = -c;
+
+    return *this;
+  }
+
+  /**
+   * Applies the top-left fill rule to this edge function, which must be
+   * oriented so that the inside of the triangle is positive. Points on the
+   * line become negative, unless the line is a left edge (the inside is to its
+   * right) or a top edge (it is horizontal and the inside is below it, with Y
+   * up).
+   *
+   * Of two triangles sharing an edge, exactly one of them is on the top or left
+   * of it. With this rule, the pixels whose centers lie on the edge are covered
+   * by exactly one of the triangles.
+   *
+   * @returns This edge function.
+   */
+  FixedPointEdgeFunction &applyTopLeftRule() {
+    if (!(a > 0 || (a == 0 && b < 0))) {
+      c -= 1;
+    }
+
+    return *this;
+  }
+};
+
+/**
+ * The plane equation of a value interpolated linearly across a 2D triangle, in
+ * the form \f$P(x, y) = ax + by + c\f$.
+ *
+ * The plane equation is set up once per triangle from the values at its 3
+ * vertices. Afterwards, the value at any point can be evaluated without
+ * computing barycentric coordinates, and stepping one unit along the x axis
+ * adds \f$a\f$ to the value.
+ */
+struct PlaneEquation {
+  double a; /**< The rate of change of the value along the x axis. */
+  double b; /**< The rate of change of the value along the y axis. */
+  double c; /**< The value at the origin. */
+
+  /**
+   * Creates the plane equation of a value across a triangle \f$ABC\f$.
+   *
+   * @param edgeBC The edge function of the edge opposite to vertex A.
+   * @param edgeCA The edge function of the edge opposite to vertex B.
+   * @param edgeAB The edge function of the edge opposite to vertex C.
+   * @param area The edge function of edge AB evaluated at vertex C, which is
+   * twice the signed area of the triangle.
+   * @param valueA The value at vertex A.
+   * @param valueB The value at vertex B.
+   * @param valueC The value at vertex C.
+   */
+  PlaneEquation(const EdgeFunction &edgeBC, const EdgeFunction &edgeCA,
+                const EdgeFunction &edgeAB, double area, double valueA,
+                double valueB, double valueC)
+      : a((valueA * edgeBC.a + valueB * edgeCA.a + valueC * edgeAB.a) / area),
+        b((valueA * edgeBC.b + valueB * edgeCA.b + valueC * edgeAB.b) / area),
+        c((valueA * edgeBC.c + valueB * edgeCA.c + valueC * edgeAB.c) / area) {
+  }
+
+  /**
+   * Evaluates this plane equation at the specified point.
+   *
+   * @param x The x-coordinate of the point.
+   * @param y The y-coordinate of the point.
+   * @returns The interpolated value at the point.
+   */
+  double operator()(double x, double y) const { return a * x + b * y + c; }
+};
+
 /**
  * Computes and returns the barycentric coordinates of a point in a triangle.
  *
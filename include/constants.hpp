@@ -44,6 +44,15 @@ enum class CullMode {
   Back = -1 /**< Culls back faces. */
 };
 
+/**
+ * The type of a light, as resolved by a {@link LightList}.
+ */
+enum class LightType {
+  Ambient /**< An {@link AmbientLight}. */,
+  Point /**< A {@link PointLight}. */,
+  Other /**< Any other light, which the built-in materials ignore. */
+};
+
 /**
  * The default up direction.
  */
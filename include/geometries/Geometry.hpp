@@ -1,3 +1,5 @@
+#include "math/BoundingBox.hpp"
+#include "math/BoundingSphere.hpp"
 #include "primitives/BufferAttribute.hpp"
 #include <memory>
 #include <optional>
@@ -64,6 +66,16 @@ public:
                                       front-facing. Used in conjunction with
                                       {@link Material#cullMode} to determine if
                                       a triangle should be drawn or not. */
+  std::optional<BoundingBox>
+      boundingBox; /**< The bounding box of the vertex positions, which is
+                      missing until {@link #computeBoundingBox} is called. The
+                      renderer computes it when it is needed and missing. It
+                      must be recomputed when the vertex positions change. */
+  std::optional<BoundingSphere>
+      boundingSphere; /**< The bounding sphere of the vertex positions, which
+                         is missing until {@link #computeBoundingSphere} is
+                         called. Like {@link #boundingBox}, the renderer
+                         computes it when it is needed and missing. */
 
   /**
    * Creates a new 3D geometry with the specified vertex buffer and normal
@@ -93,6 +105,22 @@ public:
   void setIndices(BufferAttribute<int> _faceIndices) {
     faceIndices = _faceIndices;
   }
+
+  /**
+   * Computes the bounding box of the vertex positions of this geometry and
+   * stores it in {@link #boundingBox}.
+   */
+  void computeBoundingBox() {
+    boundingBox = BoundingBox::fromBufferAttribute(vertexPositions);
+  }
+
+  /**
+   * Computes a bounding sphere of the vertex positions of this geometry and
+   * stores it in {@link #boundingSphere}.
+   */
+  void computeBoundingSphere() {
+    boundingSphere = BoundingSphere::fromBufferAttribute(vertexPositions);
+  }
 };
 
 } // namespace t
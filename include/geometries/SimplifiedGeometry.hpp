@@ -0,0 +1,459 @@
+#include "geometries/Geometry.hpp"
+#include "math/Vector3.hpp"
+#include "primitives/BufferAttribute.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <queue>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#ifndef SIMPLIFIEDGEOMETRY_HPP
+#define SIMPLIFIEDGEOMETRY_HPP
+
+namespace t {
+
+/**
+ * A geometry with fewer triangles than another geometry, but approximately
+ * the same shape. Used for the levels of detail of meshes; see {@link
+ * Mesh#addLevelOfDetail}.
+ *
+ * The simplification collapses edges one at a time, the cheapest first, using
+ * the [quadric error
+ * metric](https://www.cs.cmu.edu/~garland/Papers/quadrics.pdf) to estimate how
+ * far every collapse moves the surface. Vertices at the same position are
+ * merged first, so non-indexed geometries such as {@link UtahTeapot} can be
+ * simplified too. Vertices on the open boundaries of the geometry and vertices
+ * with several normals (i.e. on hard edges) are kept in place, so that the
+ * simplified geometry has neither holes nor cracks where the original one has
+ * none.
+ *
+ * Every vertex of the simplified geometry is a vertex of the original one, so
+ * the simplified geometry stays within the bounding volumes of the original.
+ *
+ * ```cpp
+ * auto teapot = UtahTeapot();
+ * auto simplifiedTeapot = SimplifiedGeometry(teapot, 0.25); // 25% triangles
+ * ```
+ *
+ * \ingroup geometries
+ */
+class SimplifiedGeometry : public Geometry {
+public:
+  /**
+   * Creates a new simplified geometry from another geometry.
+   *
+   * The simplification stops at the requested number of triangles, or
+   * earlier if no more edges can be collapsed without flipping triangles or
+   * changing the topology of the geometry. Since the vertices on boundaries
+   * and hard edges never move, geometries with many of them cannot be
+   * simplified below a floor: the 3488 triangles of the {@link UtahTeapot}
+   * do not go below 316, about 9%, so every ratio below about 0.09 gives the
+   * same geometry.
+   *
+   * @param geometry The geometry to simplify.
+   * @param ratio The number of triangles to keep relative to the number of
+   * triangles of the geometry, between 0 and 1.
+   */
+  SimplifiedGeometry(const Geometry &geometry, double ratio)
+      : Geometry(BufferAttribute<double>({}, 3),
+                 BufferAttribute<double>({}, 3)) {
+    frontFace = geometry.frontFace;
+    setIndices(BufferAttribute<int>({}, 3));
+    simplify(geometry, std::clamp(ratio, 0.0, 1.0));
+  }
+
+private:
+  /**
+   * A symmetric 4×4 matrix \f$Q\f$ such that \f$v^TQv\f$ is the sum of the
+   * squared distances of the point \f$v\f$ to a set of planes, weighted by
+   * the areas of the triangles on the planes.
+   */
+  struct Quadric {
+    std::array<double, 10> q{};
+
+    static Quadric fromPlane(const Vector3 &normal, double d, double weight) {
+      const auto a = normal.x, b = normal.y, c = normal.z;
+
+      return Quadric{{weight * a * a, weight * a * b, weight * a * c,
+                      weight * a * d, weight * b * b, weight * b * c,
+                      weight * b * d, weight * c * c, weight * c * d,
+                      weight * d * d}};
+    }
+
+    Quadric &operator+=(const Quadric &other) {
+      for (int i = 0; i < 10; i++) {
+        q[i] += other.q[i];
+      }
+
+      return *this;
+    }
+
+    double evaluate(const Vector3 &v) const {
+      return q[0] * v.x * v.x + 2 * q[1] * v.x * v.y + 2 * q[2] * v.x * v.z +
+             2 * q[3] * v.x + q[4] * v.y * v.y + 2 * q[5] * v.y * v.z +
+             2 * q[6] * v.y + q[7] * v.z * v.z + 2 * q[8] * v.z + q[9];
+    }
+  };
+
+  /**
+   * The collapse of an edge, which moves the vertex `from` onto the vertex
+   * `to`. The versions of the vertices tell whether the error is outdated.
+   */
+  struct Collapse {
+    double error;
+    int from;
+    int to;
+    int fromVersion;
+    int toVersion;
+
+    bool operator>(const Collapse &other) const {
+      return std::tie(error, from, to) >
+             std::tie(other.error, other.from, other.to);
+    }
+  };
+
+  struct Triangle {
+    std::array<int, 3> corners; // Indices of vertices of the source geometry
+    bool removed = false;
+  };
+
+  void simplify(const Geometry &geometry, double ratio) {
+    const auto &sourcePositions = geometry.vertexPositions;
+    const auto &sourceNormals = geometry.vertexNormals;
+    const auto sourceVertexCount =
+        static_cast<int>(sourcePositions.array.size() / 3);
+
+    // Merge the vertices at the same position. The merged vertices are the
+    // ones that collapse; their wedges are the source vertices at their
+    // position with distinct normals, which the corners of the triangles
+    // refer to.
+
+    std::map<std::array<double, 3>, int> vertexAt;
+    std::vector<int> vertexOf(sourceVertexCount);
+    std::vector<int> wedgeOfSource(sourceVertexCount);
+    std::vector<Vector3> positions;
+    std::vector<std::vector<int>> wedges;
+    std::vector<bool> locked;
+
+    for (int i = 0; i < sourceVertexCount; i++) {
+      const auto position = Vector3::fromBufferAttribute(sourcePositions, i);
+      const auto normal = Vector3::fromBufferAttribute(sourceNormals, i);
+      const auto [entry, inserted] = vertexAt.try_emplace(
+          {position.x, position.y, position.z},
+          static_cast<int>(positions.size()));
+
+      vertexOf[i] = entry->second;
+      wedgeOfSource[i] = i;
+
+      if (inserted) {
+        positions.push_back(position);
+        wedges.push_back({i});
+        locked.push_back(false);
+        continue;
+      }
+
+      auto &vertexWedges = wedges[entry->second];
+      const auto wedge =
+          std::find_if(vertexWedges.begin(), vertexWedges.end(), [&](int w) {
+            return Vector3::fromBufferAttribute(sourceNormals, w) == normal;
+          });
+
+      if (wedge == vertexWedges.end()) {
+        vertexWedges.push_back(i);
+        locked[entry->second] = true;
+      } else {
+        wedgeOfSource[i] = *wedge;
+      }
+    }
+
+    // Collect the triangles, skipping the degenerate ones, and find the open
+    // boundaries: edges shared by other than 2 triangles
+
+    std::vector<Triangle> triangles;
+    std::map<std::pair<int, int>, int> edgeTriangleCounts;
+
+    const auto addTriangle = [&](int a, int b, int c) {
+      const auto va = vertexOf[a], vb = vertexOf[b], vc = vertexOf[c];
+
+      if (va == vb || vb == vc || vc == va) {
+        return;
+      }
+
+      triangles.push_back({{wedgeOfSource[a], wedgeOfSource[b],
+                            wedgeOfSource[c]}});
+
+      for (const auto &[v0, v1] : {std::pair(va, vb), std::pair(vb, vc),
+                                   std::pair(vc, va)}) {
+        edgeTriangleCounts[std::minmax(v0, v1)]++;
+      }
+    };
+
+    if (geometry.faceIndices) {
+      const auto &indices = geometry.faceIndices.value().array;
+
+      for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+        addTriangle(indices[i], indices[i + 1], indices[i + 2]);
+      }
+    } else {
+      for (int i = 0; i + 2 < sourceVertexCount; i += 3) {
+        addTriangle(i, i + 1, i + 2);
+      }
+    }
+
+    for (const auto &[edge, count] : edgeTriangleCounts) {
+      if (count != 2) {
+        locked[edge.first] = true;
+        locked[edge.second] = true;
+      }
+    }
+
+    const auto vertexCount = static_cast<int>(positions.size());
+    const auto cornerVertex = [&](const Triangle &triangle, int corner) {
+      return vertexOf[triangle.corners[corner]];
+    };
+
+    // The quadric of a vertex is the sum of the planes of its triangles
+
+    std::vector<Quadric> quadrics(vertexCount);
+    std::vector<std::vector<int>> trianglesOf(vertexCount);
+
+    for (int i = 0; i < static_cast<int>(triangles.size()); i++) {
+      const auto &a = positions[cornerVertex(triangles[i], 0)];
+      const auto &b = positions[cornerVertex(triangles[i], 1)];
+      const auto &c = positions[cornerVertex(triangles[i], 2)];
+      const auto normal = Vector3::cross(b - a, c - a);
+      const auto area = normal.length() / 2;
+
+      for (int corner = 0; corner < 3; corner++) {
+        trianglesOf[cornerVertex(triangles[i], corner)].push_back(i);
+      }
+
+      if (area == 0) {
+        continue;
+      }
+
+      const auto unitNormal = normal / (2 * area);
+      const auto plane =
+          Quadric::fromPlane(unitNormal, -Vector3::dot(unitNormal, a), area);
+
+      for (int corner = 0; corner < 3; corner++) {
+        quadrics[cornerVertex(triangles[i], corner)] += plane;
+      }
+    }
+
+    // Collapse the cheapest edges until enough triangles are removed
+
+    std::vector<int> versions(vertexCount, 0);
+    std::vector<bool> removed(vertexCount, false);
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<>>
+        collapses;
+
+    const auto neighborsOf = [&](int vertex) {
+      std::vector<int> neighbors;
+
+      for (const auto triangle : trianglesOf[vertex]) {
+        if (triangles[triangle].removed) {
+          continue;
+        }
+
+        for (int corner = 0; corner < 3; corner++) {
+          if (cornerVertex(triangles[triangle], corner) != vertex) {
+            neighbors.push_back(cornerVertex(triangles[triangle], corner));
+          }
+        }
+      }
+
+      std::sort(neighbors.begin(), neighbors.end());
+      neighbors.erase(std::unique(neighbors.begin(), neighbors.end()),
+                      neighbors.end());
+
+      return neighbors;
+    };
+
+    const auto pushCollapse = [&](int from, int to) {
+      if (locked[from]) {
+        return;
+      }
+
+      auto quadric = quadrics[from];
+      quadric += quadrics[to];
+
+      collapses.push({quadric.evaluate(positions[to]), from, to,
+                      versions[from], versions[to]});
+    };
+
+    for (int vertex = 0; vertex < vertexCount; vertex++) {
+      for (const auto neighbor : neighborsOf(vertex)) {
+        pushCollapse(vertex, neighbor);
+      }
+    }
+
+    auto triangleCount = static_cast<int>(triangles.size());
+    const auto targetTriangleCount =
+        static_cast<int>(std::ceil(ratio * triangleCount));
+
+    while (triangleCount > targetTriangleCount && !collapses.empty()) {
+      const auto collapse = collapses.top();
+      collapses.pop();
+
+      if (removed[collapse.from] || removed[collapse.to] ||
+          versions[collapse.from] != collapse.fromVersion ||
+          versions[collapse.to] != collapse.toVersion ||
+          !canCollapse(collapse.from, collapse.to, triangles, trianglesOf,
+                       vertexOf, positions, neighborsOf)) {
+        continue;
+      }
+
+      const auto from = collapse.from;
+      const auto to = collapse.to;
+
+      for (const auto triangle : trianglesOf[from]) {
+        auto &corners = triangles[triangle].corners;
+
+        if (triangles[triangle].removed) {
+          continue;
+        }
+
+        if (std::any_of(corners.begin(), corners.end(),
+                        [&](int corner) { return vertexOf[corner] == to; })) {
+          triangles[triangle].removed = true;
+          triangleCount--;
+          continue;
+        }
+
+        for (auto &corner : corners) {
+          if (vertexOf[corner] == from) {
+            corner = wedgeOf(to, corner, wedges, sourceNormals);
+          }
+        }
+
+        trianglesOf[to].push_back(triangle);
+      }
+
+      quadrics[to] += quadrics[from];
+      removed[from] = true;
+      versions[to]++;
+
+      for (const auto neighbor : neighborsOf(to)) {
+        pushCollapse(to, neighbor);
+        pushCollapse(neighbor, to);
+      }
+    }
+
+    // Copy the remaining triangles and their vertices
+
+    std::vector<int> newIndices(sourceVertexCount, -1);
+    auto &indices = faceIndices.value().array;
+
+    for (const auto &triangle : triangles) {
+      if (triangle.removed) {
+        continue;
+      }
+
+      for (const auto corner : triangle.corners) {
+        if (newIndices[corner] == -1) {
+          newIndices[corner] =
+              static_cast<int>(vertexPositions.array.size() / 3);
+
+          for (int k = 0; k < 3; k++) {
+            vertexPositions.array.push_back(
+                sourcePositions.array[corner * 3 + k]);
+            vertexNormals.array.push_back(sourceNormals.array[corner * 3 + k]);
+          }
+        }
+
+        indices.push_back(newIndices[corner]);
+      }
+    }
+  }
+
+  /**
+   * Checks whether collapsing the vertex `from` onto the vertex `to` keeps the
+   * geometry manifold and flips none of the remaining triangles.
+   */
+  template <class NeighborsOf>
+  static bool canCollapse(int from, int to,
+                          const std::vector<Triangle> &triangles,
+                          const std::vector<std::vector<int>> &trianglesOf,
+                          const std::vector<int> &vertexOf,
+                          const std::vector<Vector3> &positions,
+                          NeighborsOf &neighborsOf) {
+    // The vertices adjacent to both must be the opposite vertices of the
+    // triangles of the edge, otherwise the collapse pinches the surface
+
+    const auto fromNeighbors = neighborsOf(from);
+    const auto toNeighbors = neighborsOf(to);
+    std::vector<int> commonNeighbors;
+
+    std::set_intersection(fromNeighbors.begin(), fromNeighbors.end(),
+                          toNeighbors.begin(), toNeighbors.end(),
+                          std::back_inserter(commonNeighbors));
+
+    auto edgeTriangleCount = 0;
+
+    for (const auto triangle : trianglesOf[from]) {
+      if (triangles[triangle].removed) {
+        continue;
+      }
+
+      std::array<int, 3> vertices;
+
+      for (int corner = 0; corner < 3; corner++) {
+        vertices[corner] = vertexOf[triangles[triangle].corners[corner]];
+      }
+
+      if (std::find(vertices.begin(), vertices.end(), to) != vertices.end()) {
+        edgeTriangleCount++;
+        continue;
+      }
+
+      // The normal of the triangle must keep its direction once the vertex
+      // moves
+
+      const auto moved = [&](int corner) -> const Vector3 & {
+        return positions[vertices[corner] == from ? to : vertices[corner]];
+      };
+
+      const auto &a = positions[vertices[0]];
+      const auto &b = positions[vertices[1]];
+      const auto &c = positions[vertices[2]];
+      const auto normal = Vector3::cross(b - a, c - a);
+      const auto movedNormal =
+          Vector3::cross(moved(1) - moved(0), moved(2) - moved(0));
+
+      if (Vector3::dot(normal, movedNormal) <= 0) {
+        return false;
+      }
+    }
+
+    return static_cast<int>(commonNeighbors.size()) == edgeTriangleCount;
+  }
+
+  /**
+   * Returns the wedge of a vertex whose normal is the closest to the normal
+   * of a source vertex.
+   */
+  static int wedgeOf(int vertex, int sourceVertex,
+                     const std::vector<std::vector<int>> &wedges,
+                     const BufferAttribute<double> &sourceNormals) {
+    const auto normal =
+        Vector3::fromBufferAttribute(sourceNormals, sourceVertex);
+
+    return *std::max_element(
+        wedges[vertex].begin(), wedges[vertex].end(), [&](int a, int b) {
+          return Vector3::dot(Vector3::fromBufferAttribute(sourceNormals, a),
+                              normal) <
+                 Vector3::dot(Vector3::fromBufferAttribute(sourceNormals, b),
+                              normal);
+        });
+  }
+};
+
+} // namespace t
+
+#endif // SIMPLIFIEDGEOMETRY_HPP
@@ -0,0 +1,107 @@
+#include "constants.hpp"
+#include "lights/AmbientLight.hpp"
+#include "lights/Light.hpp"
+#include "lights/PointLight.hpp"
+#include "math/Vector3.hpp"
+#include "math/Vector4.hpp"
+#include "primitives/Color.hpp"
+#include <functional>
+#include <vector>
+
+#ifndef LIGHTLIST_HPP
+#define LIGHTLIST_HPP
+
+namespace t {
+
+/**
+ * A list of lights, along with what the built-in materials read from them,
+ * resolved once when a light is added rather than for every fragment: the
+ * type, world position, and color of every light, and the sum of the ambient
+ * lights.
+ *
+ * The lights must not change while the list is in use.
+ *
+ * \ingroup lights
+ */
+class LightList {
+public:
+  /**
+   * What the built-in materials read from a light.
+   */
+  struct ResolvedLight {
+    LightType type;        /**< The type of the light. */
+    Vector3 worldPosition; /**< The position of the light in world space. */
+    Color color; /**< The color of the light times its intensity for ambient
+                    lights, or times its power for point lights. Black for
+                    other lights. */
+  };
+
+  std::vector<std::reference_wrapper<Light>>
+      lights; /**< The lights of the list, in the order they were added. */
+  std::vector<ResolvedLight>
+      resolvedLights; /**< The resolved lights, in the same order. */
+  Color ambient = Color(0, 0, 0); /**< The sum of the colors of the ambient
+                                     lights. */
+
+  /**
+   * Returns the number of lights in the list.
+   */
+  int size() const { return static_cast<int>(lights.size()); }
+
+  /**
+   * Removes every light from the list, keeping the memory allocated for them.
+   */
+  void clear() {
+    lights.clear();
+    resolvedLights.clear();
+    ambient = Color(0, 0, 0);
+  }
+
+  /**
+   * Adds a light to the list, resolving it from its current matrices.
+   *
+   * @param light The light to add.
+   */
+  void add(Light &light) {
+    const auto worldPosition =
+        (light.modelMatrix * Vector4(light.localPosition, 1)).toVector3();
+
+    if (light.isAmbientLight()) {
+      const auto &ambientLight = static_cast<AmbientLight &>(light);
+
+      add(light, {LightType::Ambient, worldPosition,
+                  Color(ambientLight.intensity * ambientLight.color)});
+    } else if (light.isPointLight()) {
+      const auto &pointLight = static_cast<PointLight &>(light);
+
+      add(light, {LightType::Point, worldPosition,
+                  Color(pointLight.color * pointLight.power())});
+    } else {
+      add(light, {LightType::Other, worldPosition, Color(0, 0, 0)});
+    }
+  }
+
+  /**
+   * Adds a light of another list to this list, without resolving it again.
+   *
+   * @param other The list of the light.
+   * @param index The index of the light in the other list.
+   */
+  void add(const LightList &other, int index) {
+    add(other.lights[index], other.resolvedLights[index]);
+  }
+
+private:
+  void add(Light &light, const ResolvedLight &resolvedLight) {
+    lights.push_back(light);
+    resolvedLights.push_back(resolvedLight);
+
+    if (resolvedLight.type == LightType::Ambient) {
+      ambient += resolvedLight.color;
+    }
+  }
+};
+
+} // namespace t
+
+#endif // LIGHTLIST_HPP
@@ -1,4 +1,6 @@
 #include "materials/Material.hpp"
+#include <algorithm>
+#include <array>
 #include <cmath>
 
 #ifndef M_PI
@@ -44,16 +46,26 @@ public:
   Color fragmentShader(
       const Uniforms &uniforms, const Varyings &varyings,
       const std::vector<std::reference_wrapper<Light>> &lights) override {
-    Color outputColor(0, 0, 0);
+    // Light the fragment like shadeFragments does: the ambient lights are
+    // summed first, and the colors of point lights are multiplied by their
+    // power before lighting the fragment
+
+    Color ambient(0, 0, 0);
 
     for (Light &light : lights) {
       if (light.isAmbientLight()) {
-        const auto ambientLight = dynamic_cast<AmbientLight &>(light);
-        const auto ambient = ambientLight.intensity * ambientLight.color;
+        const auto &ambientLight = static_cast<AmbientLight &>(light);
+
+        ambient += ambientLight.intensity * ambientLight.color;
+      }
+    }
+
+    Color outputColor(ambient * diffuseColor);
 
-        outputColor += ambient * diffuseColor;
-      } else if (light.isPointLight()) {
-        const auto pointLight = dynamic_cast<PointLight &>(light);
+    for (Light &light : lights) {
+      if (light.isPointLight()) {
+        const auto &pointLight = static_cast<PointLight &>(light);
+        const auto lightColor = pointLight.color * pointLight.power();
 
         const auto fragWorldPosition =
             (uniforms.modelMatrix * Vector4(varyings.localPosition, 1))
@@ -80,15 +92,96 @@ public:
           specular = std::pow(specularAngle, shininess);
         }
 
-        outputColor += diffuseColor * lambertian * pointLight.color *
-                           pointLight.power() / distance +
-                       specularColor * specular * pointLight.color *
-                           pointLight.power() / distance;
+        outputColor += diffuseColor * lambertian * lightColor / distance +
+                       specularColor * specular * lightColor / distance;
       }
     }
 
     return outputColor;
   }
+
+  void shadeFragments(const Uniforms &uniforms, FragmentBatch &fragments,
+                      const LightList &lights) override {
+    const auto size = fragments.size;
+    const auto ambient = lights.ambient * diffuseColor;
+
+    std::fill_n(fragments.red.begin(), size, ambient.x);
+    std::fill_n(fragments.green.begin(), size, ambient.y);
+    std::fill_n(fragments.blue.begin(), size, ambient.z);
+
+    // The world positions, normals, and view directions of the fragments do
+    // not depend on the lights; they are computed before the first point light
+
+    constexpr auto capacity = FragmentBatch::capacity;
+    std::array<double, capacity> positionX, positionY, positionZ;
+    std::array<double, capacity> normalX, normalY, normalZ;
+    std::array<double, capacity> viewX, viewY, viewZ;
+    bool hasWorldVectors = false;
+
+    const auto computeWorldVectors = [&] {
+      for (int i = 0; i < size; i++) {
+        const auto fragWorldPosition =
+            (uniforms.modelMatrix * Vector4(fragments.localPosition(i), 1))
+                .toVector3();
+        const auto worldNormal =
+            (uniforms.normalMatrix * fragments.localNormal(i)).normalize();
+        const auto viewDirection =
+            (uniforms.cameraPosition - fragWorldPosition).normalize();
+
+        positionX[i] = fragWorldPosition.x;
+        positionY[i] = fragWorldPosition.y;
+        positionZ[i] = fragWorldPosition.z;
+        normalX[i] = worldNormal.x;
+        normalY[i] = worldNormal.y;
+        normalZ[i] = worldNormal.z;
+        viewX[i] = viewDirection.x;
+        viewY[i] = viewDirection.y;
+        viewZ[i] = viewDirection.z;
+      }
+    };
+
+    for (const auto &light : lights.resolvedLights) {
+      if (light.type != LightType::Point) {
+        continue;
+      }
+
+      if (!hasWorldVectors) {
+        computeWorldVectors();
+        hasWorldVectors = true;
+      }
+
+      for (int i = 0; i < size; i++) {
+        const auto worldNormal = Vector3(normalX[i], normalY[i], normalZ[i]);
+
+        // Like in fragmentShader, the light direction is not normalized
+
+        const auto lightDirection =
+            light.worldPosition -
+            Vector3(positionX[i], positionY[i], positionZ[i]);
+        const double distance = Vector3::dot(lightDirection, lightDirection);
+
+        auto lambertian =
+            std::max(Vector3::dot(lightDirection, worldNormal), 0.0);
+        auto specular = 0.0;
+
+        if (lambertian > 0) {
+          const auto halfway =
+              (lightDirection + Vector3(viewX[i], viewY[i], viewZ[i]))
+                  .normalize();
+          const auto specularAngle =
+              std::max(Vector3::dot(halfway, worldNormal), 0.0);
+          specular = std::pow(specularAngle, shininess);
+        }
+
+        const auto color = diffuseColor * lambertian * light.color / distance +
+                           specularColor * specular * light.color / distance;
+
+        fragments.red[i] += color.x;
+        fragments.green[i] += color.y;
+        fragments.blue[i] += color.z;
+      }
+    }
+  }
 };
 
 } // namespace t
@@ -1,6 +1,8 @@
 #include "lights/Light.hpp"
+#include "lights/LightList.hpp"
 #include "primitives/Attributes.hpp"
 #include "primitives/Color.hpp"
+#include "primitives/FragmentBatch.hpp"
 #include "primitives/Uniforms.hpp"
 #include "primitives/Varyings.hpp"
 
@@ -17,7 +19,8 @@ namespace t {
  *
  * This class must not be instantiated directly. Instead, you can create your
  * own material by deriving from this class and implement your own {@link
- * #vertexShader} and {@link #fragmentShader}.
+ * #vertexShader} and {@link #fragmentShader}, and optionally {@link
+ * #shadeFragments}.
  *
  * \ingroup materials
  */
@@ -30,6 +33,18 @@ public:
                              another object, and thus avoid drawing that part. */
   bool depthWrite = true; /**< Whether or not to write the depth of the object
                              to the depth texture. */
+  bool earlyDepthTest =
+      true; /**< Whether or not to perform the depth test before running the
+               {@link #fragmentShader}, so that only fragments that pass the
+               depth test are shaded. Set this to `false` if the fragment
+               shader must run for every fragment the mesh covers, including
+               occluded ones. */
+  bool batchable =
+      true; /**< Whether the static meshes with this material can be merged by
+               the {@link StaticBatcher}. The shaders see batched meshes in
+               world space, with identity model and normal matrices, so set
+               this to `false` if the output depends on the local space of the
+               meshes. */
 
   virtual ~Material() = default;
 
@@ -59,6 +74,29 @@ public:
   virtual Color
   fragmentShader(const Uniforms &uniforms, const Varyings &varyings,
                  const std::vector<std::reference_wrapper<Light>> &lights) = 0;
+
+  /**
+   * Runs the fragment shader of this material for a batch of fragments, which
+   * is what the rasterizer calls. By default, it calls {@link #fragmentShader}
+   * for every fragment. Override it to shade a whole batch at once, with the
+   * same output as {@link #fragmentShader}.
+   *
+   * @param uniforms The uniforms.
+   * @param fragments The varyings of the fragments, to which the colors of the
+   * fragments are written.
+   * @param lights The list of lights in the scene, resolved for the frame.
+   */
+  virtual void shadeFragments(const Uniforms &uniforms,
+                              FragmentBatch &fragments,
+                              const LightList &lights) {
+    for (int i = 0; i < fragments.size; i++) {
+      auto localPosition = fragments.localPosition(i);
+      auto localNormal = fragments.localNormal(i);
+      Varyings varyings = {localPosition, localNormal};
+
+      fragments.setColor(i, fragmentShader(uniforms, varyings, lights.lights));
+    }
+  }
 };
 
 } // namespace t
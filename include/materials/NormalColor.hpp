@@ -1,4 +1,5 @@
 #include "materials/Material.hpp"
+#include <cmath>
 
 #ifndef NORMALCOLOR_HPP
 #define NORMALCOLOR_HPP
@@ -8,10 +9,18 @@ namespace t {
 /**
  * A material that maps the mesh's normal vectors to normalized RGB colors.
  *
+ * The normals are in local space, so the meshes with this material are not
+ * {@linkplain Material#batchable batched}.
+ *
  * \ingroup materials
  */
 class NormalColor : public Material {
 public:
+  /**
+   * Creates a new normal color material.
+   */
+  NormalColor() { batchable = false; }
+
   Vector4 vertexShader(const Uniforms &uniforms,
                        const Attributes &attributes) override {
     return uniforms.projectionMatrix * uniforms.modelViewMatrix *
@@ -23,6 +32,15 @@ public:
       const std::vector<std::reference_wrapper<Light>> &lights) override {
     return Color(varyings.localNormal.absolute());
   }
+
+  void shadeFragments(const Uniforms & /*uniforms*/, FragmentBatch &fragments,
+                      const LightList & /*lights*/) override {
+    for (int i = 0; i < fragments.size; i++) {
+      fragments.red[i] = std::abs(fragments.localNormalX[i]);
+      fragments.green[i] = std::abs(fragments.localNormalY[i]);
+      fragments.blue[i] = std::abs(fragments.localNormalZ[i]);
+    }
+  }
 };
 
 } // namespace t
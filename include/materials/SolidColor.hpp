@@ -1,4 +1,5 @@
 #include "materials/Material.hpp"
+#include <algorithm>
 
 #ifndef SOLIDCOLOR_HPP
 #define SOLIDCOLOR_HPP
@@ -34,6 +35,13 @@ public:
       const std::vector<std::reference_wrapper<Light>> &lights) override {
     return this->color;
   }
+
+  void shadeFragments(const Uniforms & /*uniforms*/, FragmentBatch &fragments,
+                      const LightList & /*lights*/) override {
+    std::fill_n(fragments.red.begin(), fragments.size, color.x);
+    std::fill_n(fragments.green.begin(), fragments.size, color.y);
+    std::fill_n(fragments.blue.begin(), fragments.size, color.z);
+  }
 };
 
 } // namespace t
@@ -0,0 +1,168 @@
+#include "math/Matrix4x4.hpp"
+#include "math/Vector3.hpp"
+#include "math/Vector4.hpp"
+#include "primitives/BufferAttribute.hpp"
+#include <algorithm>
+#include <array>
+#include <limits>
+
+#ifndef BOUNDINGBOX_HPP
+#define BOUNDINGBOX_HPP
+
+namespace t {
+
+/**
+ * The axis-aligned bounding box class.
+ *
+ * A bounding box is the smallest box, with edges parallel to the axes, that
+ * contains a set of points. It is defined by its minimum and maximum corners.
+ *
+ * \ingroup math
+ */
+class BoundingBox {
+public:
+  Vector3 min; /**< The corner of this bounding box with the smallest
+                  coordinates. */
+  Vector3 max; /**< The corner of this bounding box with the largest
+                  coordinates. */
+
+  /**
+   * Returns the bounding box of the 3D points in a {@link BufferAttribute}.
+   *
+   * @param bufferAttribute The attribute whose items are 3D points.
+   * @returns A new bounding box containing all points in the attribute.
+   */
+  static BoundingBox
+  fromBufferAttribute(const BufferAttribute<double> &bufferAttribute) {
+    auto box = BoundingBox();
+    const auto count = static_cast<int>(bufferAttribute.array.size()) /
+                       bufferAttribute.itemSize;
+
+    for (int i = 0; i < count; i++) {
+      box.expandByPoint(Vector3::fromBufferAttribute(bufferAttribute, i));
+    }
+
+    return box;
+  }
+
+  /**
+   * Creates a new empty bounding box, which contains no points.
+   */
+  BoundingBox()
+      : min(std::numeric_limits<double>::infinity(),
+            std::numeric_limits<double>::infinity(),
+            std::numeric_limits<double>::infinity()),
+        max(-std::numeric_limits<double>::infinity(),
+            -std::numeric_limits<double>::infinity(),
+            -std::numeric_limits<double>::infinity()) {}
+
+  /**
+   * Creates a new bounding box with the specified corners.
+   *
+   * @param _min The corner with the smallest coordinates.
+   * @param _max The corner with the largest coordinates.
+   */
+  BoundingBox(const Vector3 &_min, const Vector3 &_max)
+      : min(_min), max(_max) {}
+
+  /**
+   * Returns whether this bounding box is empty i.e. contains no points.
+   *
+   * @returns `true` if this bounding box is empty, `false` otherwise.
+   */
+  bool isEmpty() const {
+    return max.x < min.x || max.y < min.y || max.z < min.z;
+  }
+
+  /**
+   * Returns whether this bounding box contains the specified point. Points on
+   * the faces of the box are contained.
+   *
+   * @param point The point.
+   * @returns `true` if the point is inside this bounding box, `false`
+   * otherwise.
+   */
+  bool containsPoint(const Vector3 &point) const {
+    return point.x >= min.x && point.x <= max.x && point.y >= min.y &&
+           point.y <= max.y && point.z >= min.z && point.z <= max.z;
+  }
+
+  /**
+   * Expands this bounding box to contain the specified point.
+   *
+   * @param point The point.
+   * @returns This bounding box.
+   */
+  BoundingBox &expandByPoint(const Vector3 &point) {
+    min.set(std::min(min.x, point.x), std::min(min.y, point.y),
+            std::min(min.z, point.z));
+    max.set(std::max(max.x, point.x), std::max(max.y, point.y),
+            std::max(max.z, point.z));
+
+    return *this;
+  }
+
+  /**
+   * Expands this bounding box to contain another bounding box.
+   *
+   * @param box The other bounding box.
+   * @returns This bounding box.
+   */
+  BoundingBox &expandByBox(const BoundingBox &box) {
+    min.set(std::min(min.x, box.min.x), std::min(min.y, box.min.y),
+            std::min(min.z, box.min.z));
+    max.set(std::max(max.x, box.max.x), std::max(max.y, box.max.y),
+            std::max(max.z, box.max.z));
+
+    return *this;
+  }
+
+  /**
+   * Returns the center of this bounding box.
+   *
+   * @returns The center of this bounding box.
+   */
+  Vector3 center() const { return (min + max) / 2; }
+
+  /**
+   * Returns the bounding box of the corners of this bounding box after they
+   * are transformed by the specified affine transformation matrix.
+   *
+   * Note that this method does not modify this instance.
+   *
+   * @param matrix The transformation matrix.
+   * @returns A new bounding box containing the transformed box.
+   */
+  BoundingBox transform(const Matrix4x4 &matrix) const {
+    auto box = BoundingBox();
+
+    if (isEmpty()) {
+      return box;
+    }
+
+    for (const auto &corner : corners()) {
+      const auto transformedCorner = matrix * Vector4(corner, 1);
+
+      box.expandByPoint(Vector3(transformedCorner.x, transformedCorner.y,
+                                transformedCorner.z));
+    }
+
+    return box;
+  }
+
+  /**
+   * Returns the 8 corners of this bounding box.
+   *
+   * @returns The corners of this bounding box.
+   */
+  std::array<Vector3, 8> corners() const {
+    return {Vector3(min.x, min.y, min.z), Vector3(max.x, min.y, min.z),
+            Vector3(min.x, max.y, min.z), Vector3(max.x, max.y, min.z),
+            Vector3(min.x, min.y, max.z), Vector3(max.x, min.y, max.z),
+            Vector3(min.x, max.y, max.z), Vector3(max.x, max.y, max.z)};
+  }
+};
+
+} // namespace t
+
+#endif // BOUNDINGBOX_HPP
@@ -0,0 +1,113 @@
+#include "math/BoundingBox.hpp"
+#include "math/Matrix4x4.hpp"
+#include "math/Vector3.hpp"
+#include "primitives/BufferAttribute.hpp"
+#include <algorithm>
+#include <cmath>
+
+#ifndef BOUNDINGSPHERE_HPP
+#define BOUNDINGSPHERE_HPP
+
+namespace t {
+
+/**
+ * The bounding sphere class.
+ *
+ * A bounding sphere is a sphere that contains a set of points. It is not
+ * necessarily the smallest one, but it is cheap to transform and to test
+ * against planes.
+ *
+ * \ingroup math
+ */
+class BoundingSphere {
+public:
+  Vector3 center; /**< The center of this bounding sphere. */
+  double radius;  /**< The radius of this bounding sphere, negative if it is
+                     empty. */
+
+  /**
+   * Returns a bounding sphere of the 3D points in a {@link BufferAttribute}.
+   * The sphere is centered on the bounding box of the points.
+   *
+   * @param bufferAttribute The attribute whose items are 3D points.
+   * @returns A new bounding sphere containing all points in the attribute.
+   */
+  static BoundingSphere
+  fromBufferAttribute(const BufferAttribute<double> &bufferAttribute) {
+    const auto box = BoundingBox::fromBufferAttribute(bufferAttribute);
+
+    if (box.isEmpty()) {
+      return BoundingSphere();
+    }
+
+    auto sphere = BoundingSphere(box.center(), 0);
+    const auto count = static_cast<int>(bufferAttribute.array.size()) /
+                       bufferAttribute.itemSize;
+
+    for (int i = 0; i < count; i++) {
+      const auto point = Vector3::fromBufferAttribute(bufferAttribute, i);
+
+      sphere.radius = std::max(sphere.radius, (point - sphere.center).length());
+    }
+
+    return sphere;
+  }
+
+  /**
+   * Creates a new empty bounding sphere, which contains no points.
+   */
+  BoundingSphere() : center(0, 0, 0), radius(-1) {}
+
+  /**
+   * Creates a new bounding sphere with the specified center and radius.
+   *
+   * @param _center The center of the sphere.
+   * @param _radius The radius of the sphere.
+   */
+  BoundingSphere(const Vector3 &_center, double _radius)
+      : center(_center), radius(_radius) {}
+
+  /**
+   * Returns whether this bounding sphere is empty i.e. contains no points.
+   *
+   * @returns `true` if this bounding sphere is empty, `false` otherwise.
+   */
+  bool isEmpty() const { return radius < 0; }
+
+  /**
+   * Returns whether this bounding sphere contains the specified point. Points
+   * on the surface of the sphere are contained.
+   *
+   * @param point The point.
+   * @returns `true` if the point is inside this bounding sphere, `false`
+   * otherwise.
+   */
+  bool containsPoint(const Vector3 &point) const {
+    return (point - center).length() <= radius;
+  }
+
+  /**
+   * Returns a bounding sphere of the points in this bounding sphere after they
+   * are transformed by the specified affine transformation matrix.
+   *
+   * Note that this method does not modify this instance.
+   *
+   * @param matrix The transformation matrix.
+   * @returns A new bounding sphere containing the transformed points.
+   */
+  BoundingSphere transform(const Matrix4x4 &matrix) const {
+    if (isEmpty()) {
+      return BoundingSphere();
+    }
+
+    const auto transformedCenter = matrix * Vector4(center, 1);
+
+    return BoundingSphere(Vector3(transformedCenter.x, transformedCenter.y,
+                                  transformedCenter.z),
+                          radius * matrix.maxScaleOnAxis());
+  }
+};
+
+} // namespace t
+
+#endif // BOUNDINGSPHERE_HPP
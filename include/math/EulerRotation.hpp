@@ -48,6 +48,16 @@ public:
     return *this;
   }
 
+  /**
+   * Returns whether two Euler rotations are equal, including their orders.
+   *
+   * @param a An Euler rotation.
+   * @param b Another Euler rotation.
+   * @returns `true` if `a` equals `b`, `false` otherwise.
+   */
+  friend bool operator==(const EulerRotation &a,
+                         const EulerRotation &b) = default;
+
   /**
    * Adds 2 Euler rotations.
    *
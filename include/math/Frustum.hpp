@@ -0,0 +1,144 @@
+#include "math/BoundingBox.hpp"
+#include "math/BoundingSphere.hpp"
+#include "math/Matrix4x4.hpp"
+#include "math/Vector3.hpp"
+#include "math/Vector4.hpp"
+#include <array>
+
+#ifndef FRUSTUM_HPP
+#define FRUSTUM_HPP
+
+namespace t {
+
+/**
+ * The view frustum class.
+ *
+ * A frustum is the convex volume bounded by 6 planes that is visible to a
+ * camera. Each plane is stored as a 4D vector \f$(a, b, c, d)\f$, where
+ * \f$(a, b, c)\f$ is the unit normal of the plane pointing inside the frustum,
+ * so that the signed distance of a point \f$(x, y, z)\f$ to the plane is
+ * \f$ax + by + cz + d\f$.
+ *
+ * \ingroup math
+ */
+class Frustum {
+public:
+  std::array<Vector4, 6> planes; /**< The left, right, bottom, top, near, and
+                                    far planes of this frustum. */
+
+  /**
+   * Returns the frustum of the points that a projection matrix transforms
+   * into the NDC cube, from \f$(-1, -1, -1)\f$ to \f$(1, 1, 1)\f$.
+   *
+   * With a projection matrix, this is the frustum of the camera in view space.
+   * With the product of a projection and a view matrix, it is the frustum in
+   * world space, and so on.
+   *
+   * @param matrix The projection matrix.
+   * @returns The frustum of the projection matrix.
+   */
+  static Frustum fromMatrix(const Matrix4x4 &matrix) {
+    const auto row = [&](int i) {
+      return Vector4(matrix.elements[i * 4], matrix.elements[i * 4 + 1],
+                     matrix.elements[i * 4 + 2], matrix.elements[i * 4 + 3]);
+    };
+
+    // A point is inside the NDC cube if -w <= x, y, z <= w in clip space
+
+    return Frustum(row(3) + row(0), row(3) - row(0), row(3) + row(1),
+                   row(3) - row(1), row(3) + row(2), row(3) - row(2));
+  }
+
+  /**
+   * Creates a new frustum with the specified planes, which need not be
+   * normalized.
+   *
+   * @param leftPlane The left plane.
+   * @param rightPlane The right plane.
+   * @param bottomPlane The bottom plane.
+   * @param topPlane The top plane.
+   * @param nearPlane The near plane.
+   * @param farPlane The far plane.
+   */
+  Frustum(const Vector4 &leftPlane, const Vector4 &rightPlane,
+          const Vector4 &bottomPlane, const Vector4 &topPlane,
+          const Vector4 &nearPlane, const Vector4 &farPlane)
+      : planes({leftPlane, rightPlane, bottomPlane, topPlane, nearPlane,
+                farPlane}) {
+    for (auto &plane : planes) {
+      plane /= Vector3(plane.x, plane.y, plane.z).length();
+    }
+  }
+
+  /**
+   * Returns whether the specified point is inside this frustum. Points on the
+   * planes are inside.
+   *
+   * @param point The point.
+   * @returns `true` if the point is inside this frustum, `false` otherwise.
+   */
+  bool containsPoint(const Vector3 &point) const {
+    for (const auto &plane : planes) {
+      if (distanceToPlane(plane, point) < 0) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * Returns whether the specified bounding sphere may intersect this frustum.
+   *
+   * The test is conservative: it may return `true` for a sphere near a corner
+   * of the frustum that is outside of it, but never returns `false` for a
+   * sphere that intersects it.
+   *
+   * @param sphere The bounding sphere.
+   * @returns `false` if the sphere is entirely outside this frustum, `true`
+   * otherwise.
+   */
+  bool intersectsSphere(const BoundingSphere &sphere) const {
+    for (const auto &plane : planes) {
+      if (distanceToPlane(plane, sphere.center) < -sphere.radius) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * Returns whether the specified bounding box may intersect this frustum.
+   *
+   * The test is conservative in the same way as {@link #intersectsSphere}.
+   *
+   * @param box The bounding box.
+   * @returns `false` if the box is entirely outside this frustum, `true`
+   * otherwise.
+   */
+  bool intersectsBox(const BoundingBox &box) const {
+    for (const auto &plane : planes) {
+      // The corner of the box farthest along the normal of the plane
+
+      const auto corner = Vector3(plane.x > 0 ? box.max.x : box.min.x,
+                                  plane.y > 0 ? box.max.y : box.min.y,
+                                  plane.z > 0 ? box.max.z : box.min.z);
+
+      if (distanceToPlane(plane, corner) < 0) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+private:
+  static double distanceToPlane(const Vector4 &plane, const Vector3 &point) {
+    return plane.x * point.x + plane.y * point.y + plane.z * point.z + plane.w;
+  }
+};
+
+} // namespace t
+
+#endif // FRUSTUM_HPP
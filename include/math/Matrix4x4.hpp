@@ -2,6 +2,7 @@
 #include "Matrix3x3.hpp"
 #include "Vector3.hpp"
 #include "Vector4.hpp"
+#include <algorithm>
 #include <array>
 #include <cmath>
 
@@ -376,6 +377,21 @@ public:
     return Matrix3x3(n11, n12, n13, n21, n22, n23, n31, n32, n33);
   }
 
+  /**
+   * Returns the largest scale factor of this matrix along the axes i.e. the
+   * length of the longest of the first 3 columns.
+   *
+   * For an affine transformation matrix, no distance is scaled by more than
+   * this factor.
+   *
+   * @returns The largest scale factor of this matrix along the axes.
+   */
+  double maxScaleOnAxis() const {
+    return std::sqrt(std::max({n11 * n11 + n21 * n21 + n31 * n31,
+                               n12 * n12 + n22 * n22 + n32 * n32,
+                               n13 * n13 + n23 * n23 + n33 * n33}));
+  }
+
   /**
    * Returns the element at the specified index of this matrix without bounds
    * checking and assuming row-major ordering.
@@ -18,8 +18,8 @@ struct Fragment {
   int y; /**< The y coordinate of the fragment in screen space. */
 
   /**
-   * The less-than comparison for fragments, used for ordered sets in
-   * {@link Rasterizer} to sort fragments by their x coordinates.
+   * The less-than comparison for fragments, which orders fragments by their x
+   * coordinates.
    */
   bool operator<(const Fragment &b) const { return this->x < b.x; }
 };
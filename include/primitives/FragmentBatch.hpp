@@ -0,0 +1,107 @@
+#include "math/Vector3.hpp"
+#include "primitives/Color.hpp"
+#include <array>
+
+#ifndef FRAGMENTBATCH_HPP
+#define FRAGMENTBATCH_HPP
+
+namespace t {
+
+/**
+ * A batch of fragments of the same draw call, shaded together by {@linkplain
+ * Material#shadeFragments fragment shaders}.
+ *
+ * The varyings of the fragments and the colors output for them are stored as
+ * structures of arrays: one array per component, indexed by fragment, so that
+ * fragment shaders can process every component of the batch in a single loop.
+ *
+ * \ingroup primitives
+ */
+struct FragmentBatch {
+  /**
+   * The maximum number of fragments in a batch.
+   */
+  static constexpr int capacity = 8;
+
+  int size = 0; /**< The number of fragments in this batch. */
+
+  std::array<double, capacity> localPositionX; /**< The x components of the
+                                                  local positions. */
+  std::array<double, capacity> localPositionY; /**< The y components of the
+                                                  local positions. */
+  std::array<double, capacity> localPositionZ; /**< The z components of the
+                                                  local positions. */
+  std::array<double, capacity> localNormalX;   /**< The x components of the
+                                                  local normals. */
+  std::array<double, capacity> localNormalY;   /**< The y components of the
+                                                  local normals. */
+  std::array<double, capacity> localNormalZ;   /**< The z components of the
+                                                  local normals. */
+  std::array<double, capacity> red;   /**< The red components of the output
+                                         colors. */
+  std::array<double, capacity> green; /**< The green components of the output
+                                         colors. */
+  std::array<double, capacity> blue;  /**< The blue components of the output
+                                         colors. */
+
+  /**
+   * Appends a fragment to this batch, which must not be full.
+   *
+   * @param localPosition The local position of the fragment.
+   * @param localNormal The local normal of the fragment.
+   */
+  void push(const Vector3 &localPosition, const Vector3 &localNormal) {
+    localPositionX[size] = localPosition.x;
+    localPositionY[size] = localPosition.y;
+    localPositionZ[size] = localPosition.z;
+    localNormalX[size] = localNormal.x;
+    localNormalY[size] = localNormal.y;
+    localNormalZ[size] = localNormal.z;
+    size++;
+  }
+
+  /**
+   * Returns the local position of a fragment of this batch.
+   *
+   * @param index The index of the fragment.
+   */
+  Vector3 localPosition(int index) const {
+    return Vector3(localPositionX[index], localPositionY[index],
+                   localPositionZ[index]);
+  }
+
+  /**
+   * Returns the local normal of a fragment of this batch.
+   *
+   * @param index The index of the fragment.
+   */
+  Vector3 localNormal(int index) const {
+    return Vector3(localNormalX[index], localNormalY[index],
+                   localNormalZ[index]);
+  }
+
+  /**
+   * Returns the output color of a fragment of this batch.
+   *
+   * @param index The index of the fragment.
+   */
+  Color color(int index) const {
+    return Color(red[index], green[index], blue[index]);
+  }
+
+  /**
+   * Sets the output color of a fragment of this batch.
+   *
+   * @param index The index of the fragment.
+   * @param color The color of the fragment.
+   */
+  void setColor(int index, const Vector3 &color) {
+    red[index] = color.x;
+    green[index] = color.y;
+    blue[index] = color.z;
+  }
+};
+
+} // namespace t
+
+#endif // FRAGMENTBATCH_HPP
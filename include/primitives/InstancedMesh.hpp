@@ -0,0 +1,161 @@
+#include "geometries/Geometry.hpp"
+#include "materials/Material.hpp"
+#include "math/BoundingBox.hpp"
+#include "math/BoundingSphere.hpp"
+#include "math/Matrix4x4.hpp"
+#include "primitives/Color.hpp"
+#include "primitives/Mesh.hpp"
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#ifndef INSTANCEDMESH_HPP
+#define INSTANCEDMESH_HPP
+
+namespace t {
+
+/**
+ * A mesh drawn many times with the same geometry and material, but with
+ * different transformations and optionally colors.
+ *
+ * Compared to a {@link Mesh} per copy, an instanced mesh is a single node of
+ * the scene graph and a single draw call. The instances are culled one by one
+ * against the view frustum, then drawn with their matrices.
+ *
+ * ```cpp
+ * auto instances = std::vector<Matrix4x4>();
+ *
+ * for (int i = 0; i < 100; i++) {
+ *   instances.push_back(Matrix4x4::fromTranslation(Vector3(i, 0, 0)));
+ * }
+ *
+ * auto mesh = InstancedMesh(box, material, instances);
+ * ```
+ *
+ * \ingroup primitives
+ */
+class InstancedMesh : public Mesh {
+public:
+  std::vector<Matrix4x4>
+      instanceMatrices; /**< The matrices of the instances, which transform
+                           the geometry to the local space of this mesh. The
+                           model matrix of an instance is the model matrix of
+                           this mesh multiplied by its matrix. */
+  std::optional<std::vector<Color>>
+      instanceColors; /**< The colors of the instances, if any, in the same
+                         order as {@link #instanceMatrices}. The output of the
+                         fragment shader is multiplied by the color of the
+                         instance. */
+  std::optional<BoundingBox>
+      boundingBox; /**< The bounding box of the instances in the local space
+                      of this mesh, which is missing until {@link
+                      #computeBoundingBox} is called. The renderer computes it
+                      when it is needed and missing. It must be recomputed when
+                      the instance matrices change. */
+  std::optional<BoundingSphere>
+      boundingSphere; /**< The bounding sphere of the instances in the local
+                         space of this mesh. Like {@link #boundingBox}, it is
+                         computed when it is needed and missing. */
+
+  /**
+   * Creates a new instanced mesh with the specified geometry, material, and
+   * instance matrices.
+   *
+   * @param _geometry The geometry of every instance.
+   * @param _material The material of every instance.
+   * @param _instanceMatrices The matrices of the instances.
+   */
+  InstancedMesh(Geometry &_geometry, Material &_material,
+                std::vector<Matrix4x4> _instanceMatrices)
+      : Mesh(_geometry, _material),
+        instanceMatrices(std::move(_instanceMatrices)) {}
+
+  /**
+   * Returns the number of instances of this mesh.
+   *
+   * @returns The number of instances of this mesh.
+   */
+  int count() const { return static_cast<int>(instanceMatrices.size()); }
+
+  /**
+   * Returns whether this mesh is an {@link InstancedMesh}.
+   *
+   * @returns `true`
+   */
+  bool isInstancedMesh() const override { return true; }
+
+  /**
+   * Computes the bounding box of the instances and stores it in {@link
+   * #boundingBox}.
+   */
+  void computeBoundingBox() {
+    const auto &geometryBoundingBox = Mesh::localBoundingBox();
+
+    boundingBox = BoundingBox();
+
+    for (const auto &instanceMatrix : instanceMatrices) {
+      boundingBox->expandByBox(geometryBoundingBox.transform(instanceMatrix));
+    }
+  }
+
+  /**
+   * Computes a bounding sphere of the instances and stores it in {@link
+   * #boundingSphere}. The sphere is centered on the bounding box of the
+   * instances.
+   */
+  void computeBoundingSphere() {
+    const auto &geometryBoundingSphere = Mesh::localBoundingSphere();
+    const auto &instancesBoundingBox = localBoundingBox();
+
+    boundingSphere = BoundingSphere();
+
+    if (geometryBoundingSphere.isEmpty() || instancesBoundingBox.isEmpty()) {
+      return;
+    }
+
+    boundingSphere = BoundingSphere(instancesBoundingBox.center(), 0);
+
+    for (const auto &instanceMatrix : instanceMatrices) {
+      const auto instanceSphere =
+          geometryBoundingSphere.transform(instanceMatrix);
+
+      boundingSphere->radius = std::max(
+          boundingSphere->radius,
+          (instanceSphere.center - boundingSphere->center).length() +
+              instanceSphere.radius);
+    }
+  }
+
+  /**
+   * Returns the bounding box of the instances in the local space of this mesh.
+   * The bounding box is computed if it is missing.
+   *
+   * @returns The bounding box of the instances.
+   */
+  const BoundingBox &localBoundingBox() override {
+    if (!boundingBox) {
+      computeBoundingBox();
+    }
+
+    return boundingBox.value();
+  }
+
+  /**
+   * Returns the bounding sphere of the instances in the local space of this
+   * mesh. The bounding sphere is computed if it is missing.
+   *
+   * @returns The bounding sphere of the instances.
+   */
+  const BoundingSphere &localBoundingSphere() override {
+    if (!boundingSphere) {
+      computeBoundingSphere();
+    }
+
+    return boundingSphere.value();
+  }
+};
+
+} // namespace t
+
+#endif // INSTANCEDMESH_HPP
@@ -0,0 +1,28 @@
+#include "geometries/Geometry.hpp"
+#include <functional>
+
+#ifndef LEVELOFDETAIL_HPP
+#define LEVELOFDETAIL_HPP
+
+namespace t {
+
+/**
+ * A level of detail of a {@link Mesh}: a simpler geometry to draw the mesh
+ * with when it is small on the screen.
+ *
+ * @see Mesh#addLevelOfDetail
+ *
+ * \ingroup primitives
+ */
+struct LevelOfDetail {
+  std::reference_wrapper<Geometry>
+      geometry; /**< The geometry of this level, usually a {@link
+                   SimplifiedGeometry} of the geometry of the mesh. */
+  double screenSize; /**< The size on the screen below which this level is
+                        drawn, as a fraction of the height of the render
+                        target covered by the bounding sphere of the mesh. */
+};
+
+} // namespace t
+
+#endif // LEVELOFDETAIL_HPP
@@ -1,7 +1,10 @@
 #include "geometries/Geometry.hpp"
 #include "materials/Material.hpp"
+#include "primitives/LevelOfDetail.hpp"
 #include "primitives/Object3D.hpp"
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 #ifndef MESH_HPP
 #define MESH_HPP
@@ -19,6 +22,21 @@ class Mesh : public Object3D {
 public:
   Geometry &geometry; /**< The geometry of this mesh. */
   Material &material; /**< The material of this mesh. */
+  bool occluder = false; /**< Whether this mesh hides the meshes behind it
+                            during occlusion culling. Large opaque meshes such
+                            as walls make good occluders. See {@link
+                            Rasterizer#occlusionCulling}. */
+  bool isStatic = false; /**< Whether this mesh does not move, so that it can
+                            be merged with the other static meshes of the
+                            same material and drawn with them in a single
+                            draw call. See {@link StaticBatcher}. Meshes with
+                            levels of detail or whose material is not {@link
+                            Material#batchable} are never batched. */
+  std::vector<LevelOfDetail>
+      levelsOfDetail; /**< The simpler geometries to draw this mesh with when
+                         it is small on the screen, from the largest to the
+                         smallest screen size. See {@link
+                         #addLevelOfDetail}. */
 
   /**
    * Creates a new mesh with the specified geometry and material.
@@ -38,6 +56,102 @@ public:
    * @returns `true`
    */
   bool isMesh() const override { return true; }
+
+  /**
+   * Adds a level of detail to this mesh, which is drawn instead of {@link
+   * #geometry} when the bounding sphere of the mesh covers less than the
+   * specified fraction of the height of the render target. Among the levels
+   * whose screen sizes are larger than the size of the mesh, the one with the
+   * smallest screen size is drawn.
+   *
+   * ```cpp
+   * auto teapot = UtahTeapot();
+   * auto teapotLod1 = SimplifiedGeometry(teapot, 0.25);
+   * auto teapotLod2 = SimplifiedGeometry(teapot, 0.1);
+   *
+   * auto mesh = Mesh(teapot, material);
+   * mesh.addLevelOfDetail(teapotLod1, 0.3).addLevelOfDetail(teapotLod2, 0.1);
+   * ```
+   *
+   * The levels of detail must fit in the bounding volumes of {@link
+   * #geometry}, which are used for culling; a {@link SimplifiedGeometry} does.
+   * A mesh with levels of detail is not merged into a static batch, even if
+   * it is {@linkplain #isStatic static}.
+   *
+   * @param levelGeometry The geometry of the level of detail.
+   * @param screenSize The size on the screen below which the level is drawn.
+   * @returns This mesh.
+   */
+  Mesh &addLevelOfDetail(Geometry &levelGeometry, double screenSize) {
+    const auto level =
+        std::find_if(levelsOfDetail.begin(), levelsOfDetail.end(),
+                     [&](const LevelOfDetail &other) {
+                       return other.screenSize < screenSize;
+                     });
+
+    levelsOfDetail.insert(level, {levelGeometry, screenSize});
+
+    return *this;
+  }
+
+  /**
+   * Returns the geometry to draw this mesh with at the specified size on the
+   * screen: the level of detail with the smallest screen size larger than
+   * the size, or {@link #geometry} if there is none.
+   *
+   * @param screenSize The fraction of the height of the render target covered
+   * by the bounding sphere of this mesh.
+   * @returns The geometry to draw.
+   */
+  Geometry &geometryForScreenSize(double screenSize) {
+    for (auto level = levelsOfDetail.rbegin(); level != levelsOfDetail.rend();
+         level++) {
+      if (screenSize < level->screenSize) {
+        return level->geometry;
+      }
+    }
+
+    return geometry;
+  }
+
+  /**
+   * Returns whether this mesh is an {@link InstancedMesh}.
+   *
+   * Used internally before casting a {@link Mesh} to an {@link InstancedMesh}.
+   *
+   * @returns `false`
+   */
+  virtual bool isInstancedMesh() const { return false; }
+
+  /**
+   * Returns the bounding box of this mesh in local space, which is the
+   * bounding box of its geometry. The bounding box is computed if it is
+   * missing.
+   *
+   * @returns The bounding box of this mesh in local space.
+   */
+  virtual const BoundingBox &localBoundingBox() {
+    if (!geometry.boundingBox) {
+      geometry.computeBoundingBox();
+    }
+
+    return geometry.boundingBox.value();
+  }
+
+  /**
+   * Returns the bounding sphere of this mesh in local space, which is the
+   * bounding sphere of its geometry. The bounding sphere is computed if it is
+   * missing.
+   *
+   * @returns The bounding sphere of this mesh in local space.
+   */
+  virtual const BoundingSphere &localBoundingSphere() {
+    if (!geometry.boundingSphere) {
+      geometry.computeBoundingSphere();
+    }
+
+    return geometry.boundingSphere.value();
+  }
 };
 
 } // namespace t
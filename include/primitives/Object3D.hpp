@@ -1,4 +1,5 @@
 #include "math/EulerRotation.hpp"
+#include "math/Matrix3x3.hpp"
 #include "math/Matrix4x4.hpp"
 #include "math/Vector3.hpp"
 #include <functional>
@@ -41,13 +42,21 @@ public:
                                 3D object. This is calculated automatically by
                                 default during the render process from {@link
                                 #localPosition}, {@link #localRotation}, and
-                                {@link localScale}.
+                                {@link localScale}, only when they changed.
                               */
   Matrix4x4 modelMatrix =
       Matrix4x4::identity(); /**< The model matrix of this 3D object,
                                 transformating local space to world space. This
                                 is calculated automatically by default during
-                                the render process. */
+                                the render process, only when the local matrix
+                                or the model matrix of the parent changed. */
+  Matrix3x3 normalMatrix =
+      Matrix3x3::identity(); /**< The normal matrix of this 3D object,
+                                transforming normals from local space to world
+                                space: the inverse transpose of the upper-left
+                                \f$3 \times 3\f$ part of {@link #modelMatrix}.
+                                It is calculated along with the model matrix.
+                              */
   std::vector<std::reference_wrapper<Object3D>>
       children; /**< The children of this 3D object. */
 
@@ -137,16 +146,27 @@ public:
    * Updates the local transformation matrix of this 3D object.
    *
    * The local transformation matrix is calculated from the local position,
-   * rotation, and scale of this 3D object.
+   * rotation, and scale of this 3D object. It is only recalculated if they
+   * changed since the last update.
    *
    * @returns This 3D object.
    */
   Object3D &updateLocalMatrix() {
+    if (localPosition == matrixPosition && localRotation == matrixRotation &&
+        localScale == matrixScale) {
+      return *this;
+    }
+
     Matrix4x4 translationMatrix = Matrix4x4::fromTranslation(localPosition);
     Matrix4x4 rotationMatrix = Matrix4x4::fromRotation(localRotation);
     Matrix4x4 scaleMatrix = Matrix4x4::fromScale(localScale);
 
     localMatrix.copy(translationMatrix * rotationMatrix * scaleMatrix);
+    matrixPosition = localPosition;
+    matrixRotation = localRotation;
+    matrixScale = localScale;
+    localMatrixChanged = true;
+
     return *this;
   }
 
@@ -158,17 +178,66 @@ public:
    * this 3D object. If this 3D object has no parent, the model matrix is the
    * same as the local matrix.
    *
+   * The model matrix and the normal matrix are only recalculated if the local
+   * matrix was updated, or if the model matrix of the parent changed, since
+   * the last update. The parent must be updated first.
+   *
    * @returns This 3D object.
    */
   Object3D &updateModelMatrix() {
-    if (parent) {
-      modelMatrix.copy(parent.value().get().modelMatrix * this->localMatrix);
+    const Object3D *parentObject = parent ? &parent.value().get() : nullptr;
+
+    if (!localMatrixChanged && parentObject == matrixParent &&
+        (!parentObject ||
+         parentObject->modelMatrixVersion == matrixParentVersion)) {
+      return *this;
+    }
+
+    if (parentObject) {
+      setModelMatrix(parentObject->modelMatrix * this->localMatrix,
+                     parentObject);
     } else {
-      modelMatrix.copy(localMatrix);
+      setModelMatrix(localMatrix, nullptr);
     }
 
     return *this;
   }
+
+private:
+  friend class TransformHierarchy;
+
+  // The local transformation that the local matrix was calculated from, which
+  // is the identity to begin with
+
+  Vector3 matrixPosition = Vector3(0, 0, 0);
+  EulerRotation matrixRotation =
+      EulerRotation(0, 0, 0, EulerRotationOrder::Xyz);
+  Vector3 matrixScale = Vector3(1, 1, 1);
+
+  // Whether the local matrix changed since the model matrix was calculated
+
+  bool localMatrixChanged = false;
+
+  // The parent and its model matrix version that the model matrix was
+  // calculated from. The version increases every time the model matrix is
+  // recalculated.
+
+  const Object3D *matrixParent = nullptr;
+  unsigned long matrixParentVersion = 0;
+  unsigned long modelMatrixVersion = 0;
+
+  /**
+   * Sets the model matrix calculated from the local matrix and the model
+   * matrix of the parent, and the normal matrix.
+   */
+  void setModelMatrix(const Matrix4x4 &matrix, const Object3D *parentObject) {
+    modelMatrix.copy(matrix);
+    normalMatrix.copy(modelMatrix.topLeft3x3Matrix().inverse().transpose());
+    localMatrixChanged = false;
+    matrixParent = parentObject;
+    matrixParentVersion = parentObject ? parentObject->modelMatrixVersion : 0;
+    modelMatrixVersion++;
+  }
 };
 
 } // namespace t
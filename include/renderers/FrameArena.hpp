@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+#ifndef FRAMEARENA_HPP
+#define FRAMEARENA_HPP
+
+namespace t {
+
+/**
+ * A memory resource that allocates the scratch memory of a frame by bumping
+ * an offset in a block of memory, and frees it all at once when the frame
+ * ends.
+ *
+ * Deallocating does nothing; the memory is only reclaimed by {@link #reset},
+ * which takes constant time. When an allocation does not fit, a new block is
+ * taken from the upstream resource, and the next reset merges the blocks into
+ * one that fits everything allocated so far. Once the arena has grown to fit
+ * the largest frame, frames no longer allocate from the upstream resource.
+ *
+ * The arena is not thread-safe.
+ *
+ * \ingroup renderers
+ */
+class FrameArena : public std::pmr::memory_resource {
+public:
+  /**
+   * Creates a new arena with the specified initial capacity.
+   *
+   * @param capacity The initial capacity of the arena, in bytes.
+   * @param _upstream The resource to allocate the blocks of the arena from.
+   */
+  explicit FrameArena(
+      std::size_t capacity = 0,
+      std::pmr::memory_resource *_upstream = std::pmr::get_default_resource())
+      : upstream(_upstream) {
+    if (capacity > 0) {
+      addBlock(capacity);
+    }
+  }
+
+  FrameArena(const FrameArena &) = delete;
+  FrameArena &operator=(const FrameArena &) = delete;
+
+  ~FrameArena() override { releaseBlocks(); }
+
+  /**
+   * Frees everything allocated from the arena. The memory allocated before
+   * must no longer be used.
+   */
+  void reset() {
+    if (blocks.size() > 1) {
+      const auto capacity = this->capacity();
+
+      releaseBlocks();
+      addBlock(capacity);
+    }
+
+    offset = 0;
+    usedBytes = 0;
+  }
+
+  /**
+   * Frees everything allocated from the arena, and makes sure that it has at
+   * least the specified capacity.
+   *
+   * @param capacity The capacity of the arena, in bytes.
+   */
+  void reserve(std::size_t capacity) {
+    if (this->capacity() < capacity) {
+      releaseBlocks();
+      addBlock(capacity);
+    }
+
+    reset();
+  }
+
+  /**
+   * Returns the number of bytes allocated since the last reset, including the
+   * padding between allocations.
+   */
+  std::size_t used() const { return usedBytes; }
+
+  /**
+   * Returns the largest number of bytes that were allocated between two
+   * resets, which is the capacity that the arena needs to never grow again.
+   */
+  std::size_t peakUsage() const { return peakBytes; }
+
+  /**
+   * Returns the total size of the blocks of the arena, in bytes.
+   */
+  std::size_t capacity() const {
+    std::size_t capacity = 0;
+
+    for (const auto &block : blocks) {
+      capacity += block.size;
+    }
+
+    return capacity;
+  }
+
+protected:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+    if (auto *pointer = allocateFromLastBlock(bytes, alignment)) {
+      return pointer;
+    }
+
+    // Grow geometrically, so that a frame only adds a few blocks
+
+    addBlock(std::max(bytes + alignment, std::max(capacity(), minBlockSize)));
+
+    return allocateFromLastBlock(bytes, alignment);
+  }
+
+  void do_deallocate(void *, std::size_t, std::size_t) override {}
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override {
+    return this == &other;
+  }
+
+private:
+  static constexpr std::size_t minBlockSize = 4096;
+
+  struct Block {
+    std::byte *data;
+    std::size_t size;
+  };
+
+  std::pmr::memory_resource *upstream;
+  std::vector<Block> blocks;
+  std::size_t offset = 0; // The offset of the free memory in the last block
+  std::size_t usedBytes = 0;
+  std::size_t peakBytes = 0;
+
+  void *allocateFromLastBlock(std::size_t bytes, std::size_t alignment) {
+    if (blocks.empty()) {
+      return nullptr;
+    }
+
+    const auto &block = blocks.back();
+    void *pointer = block.data + offset;
+    auto space = block.size - offset;
+
+    if (!std::align(alignment, bytes, pointer, space)) {
+      return nullptr;
+    }
+
+    const auto end = static_cast<std::byte *>(pointer) + bytes - block.data;
+
+    usedBytes += static_cast<std::size_t>(end) - offset;
+    peakBytes = std::max(peakBytes, usedBytes);
+    offset = static_cast<std::size_t>(end);
+
+    return pointer;
+  }
+
+  void addBlock(std::size_t size) {
+    blocks.push_back({static_cast<std::byte *>(upstream->allocate(
+                          size, alignof(std::max_align_t))),
+                      size});
+    offset = 0;
+  }
+
+  void releaseBlocks() {
+    for (const auto &block : blocks) {
+      upstream->deallocate(block.data, block.size, alignof(std::max_align_t));
+    }
+
+    blocks.clear();
+  }
+};
+
+} // namespace t
+
+#endif // FRAMEARENA_HPP
@@ -0,0 +1,80 @@
+#include "math/Vector3.hpp"
+#include "primitives/Color.hpp"
+#include "primitives/RenderTarget.hpp"
+#include <algorithm>
+#include <vector>
+
+#ifndef GBUFFER_HPP
+#define GBUFFER_HPP
+
+namespace t {
+
+/**
+ * How the rasterizer shades fragments.
+ */
+enum class ShadingMode {
+  Forward,  /**< Every fragment is shaded as soon as it is rasterized. */
+  Deferred, /**< The visible fragments are written to a {@link GBuffer}, then
+               every covered pixel is shaded once. */
+};
+
+/**
+ * The geometry buffer (G-buffer) of deferred shading, which stores the inputs
+ * of the fragment shader of the visible fragment at every pixel.
+ *
+ * The geometry pass of the rasterizer writes the varyings of the fragments
+ * that pass the depth test, along with the draw call they belong to, which
+ * identifies their material and transformations. The lighting pass then runs
+ * the fragment shader once per covered pixel, however many fragments were
+ * drawn over it.
+ *
+ * \ingroup renderers
+ */
+class GBuffer {
+public:
+  RenderTarget<double> localPositions; /**< The interpolated local positions
+                                          of the fragments. */
+  RenderTarget<double> localNormals;   /**< The interpolated local normals of
+                                          the fragments. */
+  std::vector<int> drawCalls; /**< The index of the draw call of the fragment
+                                 at every pixel, in the order that the meshes
+                                 are drawn in, or -1 if no fragment covers the
+                                 pixel. */
+
+  /**
+   * Creates a new empty G-buffer with the specified size.
+   *
+   * @param width The width of the G-buffer, in pixels.
+   * @param height The height of the G-buffer, in pixels.
+   */
+  GBuffer(int width, int height)
+      : localPositions(width, height, TextureFormat::RgbDouble),
+        localNormals(width, height, TextureFormat::RgbDouble),
+        drawCalls(width * height, -1) {}
+
+  /**
+   * Marks every pixel as not covered by any fragment.
+   */
+  void clear() { std::fill(drawCalls.begin(), drawCalls.end(), -1); }
+
+  /**
+   * Writes the inputs of the fragment shader of a fragment to a pixel,
+   * replacing those of the fragment previously written there.
+   *
+   * @param x The x-coordinate of the pixel.
+   * @param y The y-coordinate of the pixel.
+   * @param drawCall The index of the draw call of the fragment.
+   * @param localPosition The local position of the fragment.
+   * @param localNormal The local normal of the fragment.
+   */
+  void write(int x, int y, int drawCall, const Vector3 &localPosition,
+             const Vector3 &localNormal) {
+    drawCalls[x + y * localPositions.width] = drawCall;
+    localPositions.write(x, y, Color(localPosition));
+    localNormals.write(x, y, Color(localNormal));
+  }
+};
+
+} // namespace t
+
+#endif // GBUFFER_HPP
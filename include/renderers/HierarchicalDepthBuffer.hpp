@@ -0,0 +1,141 @@
+#include "primitives/RenderTarget.hpp"
+#include <algorithm>
+#include <vector>
+
+#ifndef HIERARCHICALDEPTHBUFFER_HPP
+#define HIERARCHICALDEPTHBUFFER_HPP
+
+namespace t {
+
+/**
+ * A coarse level on top of a depth texture, which keeps the range of depths of
+ * every block of {@link #blockSize} × {@link #blockSize} pixels.
+ *
+ * The ranges are conservative: every depth in a block is within its range. They
+ * are widened when depths are written, and tightened again from the depth
+ * texture by {@link #refresh}. With them, fragments that are certain to fail
+ * the depth test can be rejected a whole block or span at a time, without
+ * reading the depth texture.
+ *
+ * \ingroup renderers
+ */
+class HierarchicalDepthBuffer {
+public:
+  /**
+   * The width and height of a block, in pixels.
+   */
+  static constexpr int blockSize = 8;
+
+  int width;  /**< The width of the buffer, in blocks. */
+  int height; /**< The height of the buffer, in blocks. */
+
+  /**
+   * Creates a new hierarchical depth buffer on top of the given depth texture,
+   * whose depths must all be the given depth.
+   *
+   * @param _depthTexture The depth texture.
+   * @param depth The depth that the depth texture is cleared to.
+   */
+  HierarchicalDepthBuffer(RenderTarget<double> &_depthTexture, double depth)
+      : width((_depthTexture.width + blockSize - 1) / blockSize),
+        height((_depthTexture.height + blockSize - 1) / blockSize),
+        depthTexture(_depthTexture), blocks(width * height, {depth, depth}) {}
+
+  /**
+   * Resets the depth range of every block after the depth texture was cleared
+   * to the given depth.
+   *
+   * @param depth The depth that the depth texture is cleared to.
+   */
+  void clear(double depth) {
+    std::fill(blocks.begin(), blocks.end(), Block{depth, depth});
+  }
+
+  /**
+   * Widens the depth range of the block containing the specified pixel to
+   * include the given depths. Must be called whenever depths are written to
+   * the depth texture.
+   *
+   * @param x The x-coordinate of the pixel.
+   * @param y The y-coordinate of the pixel.
+   * @param minDepth The minimum depth written.
+   * @param maxDepth The maximum depth written.
+   */
+  void expand(int x, int y, double minDepth, double maxDepth) {
+    auto &block = blocks[x / blockSize + y / blockSize * width];
+
+    block.minDepth = std::min(block.minDepth, minDepth);
+    block.maxDepth = std::max(block.maxDepth, maxDepth);
+    block.dirty = true;
+  }
+
+  /**
+   * Tightens the depth range of the specified block to the depths in the
+   * depth texture, if depths have been written to it since it was last
+   * refreshed.
+   *
+   * @param blockX The x-coordinate of the block.
+   * @param blockY The y-coordinate of the block.
+   */
+  void refresh(int blockX, int blockY) {
+    auto &block = blocks[blockX + blockY * width];
+
+    if (!block.dirty) {
+      return;
+    }
+
+    const auto minX = blockX * blockSize;
+    const auto minY = blockY * blockSize;
+    const auto maxX = std::min(minX + blockSize, depthTexture.width);
+    const auto maxY = std::min(minY + blockSize, depthTexture.height);
+    const auto &depths = depthTexture.texture.image;
+
+    block.minDepth = depths[minX + minY * depthTexture.width];
+    block.maxDepth = block.minDepth;
+
+    for (int y = minY; y < maxY; y++) {
+      for (int x = minX; x < maxX; x++) {
+        const auto depth = depths[x + y * depthTexture.width];
+
+        block.minDepth = std::min(block.minDepth, depth);
+        block.maxDepth = std::max(block.maxDepth, depth);
+      }
+    }
+
+    block.dirty = false;
+  }
+
+  /**
+   * Checks whether fragments in the block containing the specified pixel, with
+   * depths in the given range, all fail the depth test.
+   *
+   * @param x The x-coordinate of the pixel.
+   * @param y The y-coordinate of the pixel.
+   * @param minDepth The minimum depth of the fragments.
+   * @param maxDepth The maximum depth of the fragments.
+   * @param depthTest Same as {@link Material#depthTest}.
+   * @returns `true` if the fragments are certain to fail the depth test.
+   */
+  bool isHidden(int x, int y, double minDepth, double maxDepth,
+                bool depthTest) const {
+    const auto &block = blocks[x / blockSize + y / blockSize * width];
+
+    // See Rasterizer for the depth test; it is inverted if depthTest is false
+
+    return depthTest ? minDepth > block.maxDepth : maxDepth <= block.minDepth;
+  }
+
+private:
+  struct Block {
+    double minDepth;
+    double maxDepth;
+    bool dirty = false; // Whether the range may be tightened
+  };
+
+  RenderTarget<double> &depthTexture;
+  std::vector<Block> blocks;
+};
+
+} // namespace t
+
+#endif // HIERARCHICALDEPTHBUFFER_HPP
@@ -0,0 +1,202 @@
+#include "lights/Light.hpp"
+#include "lights/LightList.hpp"
+#include "lights/PointLight.hpp"
+#include "math/Matrix4x4.hpp"
+#include "math/Vector3.hpp"
+#include "math/Vector4.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#ifndef LIGHTGRID_HPP
+#define LIGHTGRID_HPP
+
+namespace t {
+
+/**
+ * The lights of a scene binned into screen tiles of {@link #tileSize} ×
+ * {@link #tileSize} pixels, for tiled light culling (Forward+).
+ *
+ * A point light only lights the fragments within its influence radius: the
+ * distance beyond which it adds less than a cutoff to the color of the
+ * fragments of the built-in materials. Every point light is assigned to the
+ * tiles
+ * that its sphere of influence overlaps on the screen, and the fragments in a
+ * tile only see the lights of their tile. Other lights, such as ambient
+ * lights, light every tile.
+ *
+ * \ingroup renderers
+ */
+class LightGrid {
+public:
+  /**
+   * The width and height of a tile, in pixels. A multiple of the width of a
+   * span, so that the pixels of a span are all in the same tile.
+   */
+  static constexpr int tileSize = 16;
+
+  int width;  /**< The width of the grid, in tiles. */
+  int height; /**< The height of the grid, in tiles. */
+
+  /**
+   * Creates a new empty light grid covering a render target of the specified
+   * size.
+   *
+   * @param pixelWidth The width of the render target, in pixels.
+   * @param pixelHeight The height of the render target, in pixels.
+   */
+  LightGrid(int pixelWidth, int pixelHeight)
+      : width((pixelWidth + tileSize - 1) / tileSize),
+        height((pixelHeight + tileSize - 1) / tileSize),
+        tiles(width * height) {}
+
+  /**
+   * Returns the influence radius of a point light: the distance beyond which
+   * the light adds at most the cutoff to any component of the color of a
+   * {@link BlinnPhong} fragment whose colors are at most 1.
+   *
+   * With \f$P\f$ the largest component of the color of the light times its
+   * power, the material's diffuse term is at most \f$P / d\f$ at a distance
+   * \f$d\f$, since the light direction it is computed from is not
+   * normalized, and its specular term is at most \f$P / d^2\f$. The radius is
+   * the distance at which their sum equals the cutoff, which is at least
+   * \f$\max(P / \text{cutoff}, \sqrt{P / \text{cutoff}})\f$.
+   *
+   * @param light The point light.
+   * @param cutoff The intensity below which the light is ignored; infinite
+   * radius if not positive.
+   * @returns The influence radius of the light.
+   */
+  static double influenceRadius(const PointLight &light, double cutoff) {
+    if (cutoff <= 0) {
+      return INFINITY;
+    }
+
+    const auto &color = light.color;
+    const auto maxComponent = std::max({color.x, color.y, color.z});
+    const auto power = std::max(maxComponent * light.power(), 0.0);
+
+    // The positive root of cutoff * d^2 - power * d - power = 0
+
+    return (power + std::sqrt(power * power + 4 * cutoff * power)) /
+           (2 * cutoff);
+  }
+
+  /**
+   * Assigns lights to the tiles they light, replacing the previous lights.
+   * The lights keep their order in every tile.
+   *
+   * @param lights The lights of the scene, already resolved.
+   * @param viewMatrix The view matrix of the camera.
+   * @param projectionMatrix The projection matrix of the camera.
+   * @param viewportMatrix The viewport matrix of the render target.
+   * @param cutoff The intensity below which point lights are ignored; see
+   * {@link #influenceRadius}.
+   */
+  void assign(const LightList &lights, const Matrix4x4 &viewMatrix,
+              const Matrix4x4 &projectionMatrix,
+              const Matrix4x4 &viewportMatrix, double cutoff) {
+    for (auto &tile : tiles) {
+      tile.clear();
+    }
+
+    for (int i = 0; i < lights.size(); i++) {
+      int minX = 0, maxX = width - 1, minY = 0, maxY = height - 1;
+
+      if (lights.resolvedLights[i].type == LightType::Point &&
+          !screenBounds(static_cast<PointLight &>(lights.lights[i].get()),
+                        lights.resolvedLights[i].worldPosition, viewMatrix,
+                        projectionMatrix, viewportMatrix, cutoff, minX, maxX,
+                        minY, maxY)) {
+        continue;
+      }
+
+      for (int y = minY; y <= maxY; y++) {
+        for (int x = minX; x <= maxX; x++) {
+          tiles[x + y * width].add(lights, i);
+        }
+      }
+    }
+  }
+
+  /**
+   * Returns the lights of the tile containing the specified pixel.
+   *
+   * @param x The x-coordinate of the pixel.
+   * @param y The y-coordinate of the pixel.
+   * @returns The lights of the tile.
+   */
+  const LightList &lightsAt(int x, int y) const {
+    return tiles[x / tileSize + y / tileSize * width];
+  }
+
+private:
+  std::vector<LightList> tiles;
+
+  /**
+   * Finds the range of tiles overlapped by the sphere of influence of a point
+   * light, from the projections of the corners of its bounding box in view
+   * space.
+   *
+   * @returns `false` if the sphere is entirely off the screen.
+   */
+  bool screenBounds(const PointLight &light, const Vector3 &worldPosition,
+                    const Matrix4x4 &viewMatrix,
+                    const Matrix4x4 &projectionMatrix,
+                    const Matrix4x4 &viewportMatrix, double cutoff, int &minX,
+                    int &maxX, int &minY, int &maxY) const {
+    const auto radius = influenceRadius(light, cutoff);
+
+    if (!std::isfinite(radius)) {
+      return true;
+    }
+
+    // The light is where the built-in materials light fragments from
+
+    const auto center = viewMatrix * Vector4(worldPosition, 1);
+
+    if (center.z - radius > 0) {
+      return false; // Behind the camera, which looks down -Z
+    }
+
+    double screenMinX = INFINITY, screenMaxX = -INFINITY;
+    double screenMinY = INFINITY, screenMaxY = -INFINITY;
+
+    for (int corner = 0; corner < 8; corner++) {
+      const auto clip =
+          projectionMatrix *
+          Vector4(center.x + (corner & 1 ? radius : -radius),
+                  center.y + (corner & 2 ? radius : -radius),
+                  center.z + (corner & 4 ? radius : -radius), 1);
+
+      // A corner behind the camera projects to the wrong side of the screen;
+      // light every tile instead
+
+      if (clip.w <= 0) {
+        return true;
+      }
+
+      const auto screen = viewportMatrix * (clip / clip.w);
+
+      screenMinX = std::min(screenMinX, screen.x);
+      screenMaxX = std::max(screenMaxX, screen.x);
+      screenMinY = std::min(screenMinY, screen.y);
+      screenMaxY = std::max(screenMaxY, screen.y);
+    }
+
+    const auto toTile = [](double pixel) {
+      return static_cast<int>(std::floor(pixel / tileSize));
+    };
+
+    minX = std::max(toTile(screenMinX), 0);
+    maxX = std::min(toTile(screenMaxX), width - 1);
+    minY = std::max(toTile(screenMinY), 0);
+    maxY = std::min(toTile(screenMaxY), height - 1);
+
+    return minX <= maxX && minY <= maxY;
+  }
+};
+
+} // namespace t
+
+#endif // LIGHTGRID_HPP
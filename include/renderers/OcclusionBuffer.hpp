@@ -0,0 +1,235 @@
+#include "algorithms.hpp"
+#include "math/Vector4.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#ifndef OCCLUSIONBUFFER_HPP
+#define OCCLUSIONBUFFER_HPP
+
+namespace t {
+
+/**
+ * A low-resolution depth buffer used for occlusion culling, in which every
+ * depth covers a block of {@link #blockSize} × {@link #blockSize} pixels.
+ *
+ * Occluders are drawn conservatively. A triangle only contributes to the
+ * pixels of a block whose centers it covers, with its farthest depth in the
+ * block. The contributions are merged into a partial layer until the pixels of
+ * the block are all covered, at which point the farthest depth of the layer
+ * becomes the depth of the block. The depth of a block is thus never nearer
+ * than what the occluders leave in the full-resolution depth texture, and
+ * anything farther than it is hidden.
+ *
+ * \ingroup renderers
+ */
+class OcclusionBuffer {
+public:
+  /**
+   * The width and height of a block, in pixels.
+   */
+  static constexpr int blockSize = 4;
+
+  int width;  /**< The width of this buffer, in blocks. */
+  int height; /**< The height of this buffer, in blocks. */
+
+  /**
+   * Creates a new occlusion buffer for a render target of the specified size.
+   *
+   * @param _pixelWidth The width of the render target, in pixels.
+   * @param _pixelHeight The height of the render target, in pixels.
+   * @param depth The depth to clear the buffer to.
+   */
+  OcclusionBuffer(int _pixelWidth, int _pixelHeight, double depth)
+      : width((_pixelWidth + blockSize - 1) / blockSize),
+        height((_pixelHeight + blockSize - 1) / blockSize),
+        pixelWidth(_pixelWidth), pixelHeight(_pixelHeight),
+        blocks(width * height, {depth}) {}
+
+  /**
+   * Clears every block to the given depth, removing the occluders drawn so
+   * far.
+   *
+   * @param depth The depth to clear the buffer to.
+   */
+  void clear(double depth) {
+    std::fill(blocks.begin(), blocks.end(), Block{depth});
+  }
+
+  /**
+   * Draws a triangle of an occluder.
+   *
+   * The triangle is snapped and covers pixels exactly like in the rasterizer,
+   * so that the occlusion buffer never claims pixels that the occluder leaves
+   * uncovered.
+   *
+   * @param vertexA The first vertex of the triangle in screen space.
+   * @param vertexB The second vertex of the triangle in screen space.
+   * @param vertexC The third vertex of the triangle in screen space.
+   * @param orientation The sign of the area of the triangles that are not
+   * culled, or 0 to cull nothing.
+   */
+  void drawTriangle(const Vector4 &vertexA, const Vector4 &vertexB,
+                    const Vector4 &vertexC, int orientation) {
+    const auto xA = toSubpixel(vertexA.x);
+    const auto yA = toSubpixel(vertexA.y);
+    const auto xB = toSubpixel(vertexB.x);
+    const auto yB = toSubpixel(vertexB.y);
+    const auto xC = toSubpixel(vertexC.x);
+    const auto yC = toSubpixel(vertexC.y);
+
+    auto edgeBC = FixedPointEdgeFunction(xB, yB, xC, yC);
+    auto edgeCA = FixedPointEdgeFunction(xC, yC, xA, yA);
+    auto edgeAB = FixedPointEdgeFunction(xA, yA, xB, yB);
+
+    const auto area = edgeAB.a * xC + edgeAB.b * yC + edgeAB.c;
+
+    if (area == 0 || area * orientation < 0) {
+      return;
+    }
+
+    if (area < 0) {
+      edgeBC.negate();
+      edgeCA.negate();
+      edgeAB.negate();
+    }
+
+    edgeBC.applyTopLeftRule();
+    edgeCA.applyTopLeftRule();
+    edgeAB.applyTopLeftRule();
+
+    const auto toPixel = [](std::int64_t subpixel) {
+      return static_cast<double>(subpixel) / (1 << subpixelBits);
+    };
+
+    const auto planeEdgeBC =
+        EdgeFunction(toPixel(xB), toPixel(yB), toPixel(xC), toPixel(yC));
+    const auto planeEdgeCA =
+        EdgeFunction(toPixel(xC), toPixel(yC), toPixel(xA), toPixel(yA));
+    const auto planeEdgeAB =
+        EdgeFunction(toPixel(xA), toPixel(yA), toPixel(xB), toPixel(yB));
+
+    const auto depth = PlaneEquation(
+        planeEdgeBC, planeEdgeCA, planeEdgeAB,
+        planeEdgeAB(toPixel(xC), toPixel(yC)), vertexA.z, vertexB.z, vertexC.z);
+
+    const auto toBlock = [](std::int64_t subpixel) {
+      return static_cast<int>((subpixel >> subpixelBits) / blockSize);
+    };
+
+    const auto minBlockX = std::max(toBlock(std::min({xA, xB, xC})), 0);
+    const auto maxBlockX =
+        std::min(toBlock(std::max({xA, xB, xC})), width - 1);
+    const auto minBlockY = std::max(toBlock(std::min({yA, yB, yC})), 0);
+    const auto maxBlockY =
+        std::min(toBlock(std::max({yA, yB, yC})), height - 1);
+
+    for (int blockY = minBlockY; blockY <= maxBlockY; blockY++) {
+      for (int blockX = minBlockX; blockX <= maxBlockX; blockX++) {
+        const auto minX = blockX * blockSize;
+        const auto minY = blockY * blockSize;
+
+        std::uint16_t mask = 0;
+
+        for (int y = 0; y < blockSize; y++) {
+          for (int x = 0; x < blockSize; x++) {
+            if (edgeBC(minX + x, minY + y) >= 0 &&
+                edgeCA(minX + x, minY + y) >= 0 &&
+                edgeAB(minX + x, minY + y) >= 0) {
+              mask |= 1 << (x + y * blockSize);
+            }
+          }
+        }
+
+        if (mask == 0) {
+          continue;
+        }
+
+        // The depth is linear, so its maximum over the covered pixels is at
+        // most its maximum at the corners of the block
+
+        auto blockDepth = -std::numeric_limits<double>::infinity();
+
+        for (const auto x : {minX, minX + blockSize - 1}) {
+          for (const auto y : {minY, minY + blockSize - 1}) {
+            blockDepth = std::max(blockDepth, depth(x, y));
+          }
+        }
+
+        merge(blockX, blockY, mask, blockDepth);
+      }
+    }
+  }
+
+  /**
+   * Checks whether something with the specified screen-space bounds and
+   * minimum depth is hidden behind the occluders drawn so far.
+   *
+   * @param minX The smallest x-coordinate of the bounds, in pixels.
+   * @param minY The smallest y-coordinate of the bounds, in pixels.
+   * @param maxX The largest x-coordinate of the bounds, in pixels.
+   * @param maxY The largest y-coordinate of the bounds, in pixels.
+   * @param minDepth The smallest depth within the bounds.
+   * @returns `true` if every block overlapping the bounds is nearer than the
+   * minimum depth.
+   */
+  bool isHidden(int minX, int minY, int maxX, int maxY,
+                double minDepth) const {
+    for (int blockY = minY / blockSize; blockY <= maxY / blockSize; blockY++) {
+      for (int blockX = minX / blockSize; blockX <= maxX / blockSize;
+           blockX++) {
+        if (!(minDepth > blocks[blockX + blockY * width].depth)) {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+private:
+  struct Block {
+    double depth; // The farthest depth of the block's pixels
+    std::uint16_t mask = 0; // The pixels covered by the partial layer
+    double partialDepth = -std::numeric_limits<double>::infinity();
+  };
+
+  int pixelWidth;
+  int pixelHeight;
+  std::vector<Block> blocks;
+
+  /**
+   * Merges the contribution of a triangle to the pixels of a block.
+   */
+  void merge(int blockX, int blockY, std::uint16_t mask, double depth) {
+    auto &block = blocks[blockX + blockY * width];
+
+    block.mask |= mask;
+    block.partialDepth = std::max(block.partialDepth, depth);
+
+    // Pixels outside the render target count as covered
+
+    std::uint16_t fullMask = 0;
+
+    for (int y = 0; y < blockSize; y++) {
+      for (int x = 0; x < blockSize; x++) {
+        if (blockX * blockSize + x < pixelWidth &&
+            blockY * blockSize + y < pixelHeight) {
+          fullMask |= 1 << (x + y * blockSize);
+        }
+      }
+    }
+
+    if ((block.mask & fullMask) == fullMask) {
+      block.depth = std::min(block.depth, block.partialDepth);
+      block.mask = 0;
+      block.partialDepth = -std::numeric_limits<double>::infinity();
+    }
+  }
+};
+
+} // namespace t
+
+#endif // OCCLUSIONBUFFER_HPP
@@ -1,13 +1,42 @@
+#include "algorithms.hpp"
 #include "cameras/Camera.hpp"
+#include "lights/LightList.hpp"
+#include "materials/BlinnPhong.hpp"
+#include "materials/NormalColor.hpp"
+#include "materials/SolidColor.hpp"
+#include "math/Frustum.hpp"
 #include "math/Matrix3x3.hpp"
-#include "primitives/Fragment.hpp"
+#include "primitives/InstancedMesh.hpp"
 #include "primitives/Mesh.hpp"
 #include "primitives/RenderTarget.hpp"
 #include "primitives/Scene.hpp"
+#include "renderers/FrameArena.hpp"
+#include "renderers/GBuffer.hpp"
+#include "renderers/HierarchicalDepthBuffer.hpp"
+#include "renderers/LightGrid.hpp"
+#include "renderers/OcclusionBuffer.hpp"
+#include "renderers/RenderStats.hpp"
+#include "renderers/SceneBvh.hpp"
+#include "renderers/SpanKernel.hpp"
+#include "renderers/StaticBatcher.hpp"
+#include "renderers/TransformHierarchy.hpp"
+#include "renderers/WorkerPool.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <cmath>
 #include <functional>
-#include <set>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <optional>
 #include <stack>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <variant>
+#include <vector>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -22,15 +51,111 @@ namespace t {
  * The most basic renderer that renders your beautiful 3D scene.
  *
  * The renderer uses rasterization and forward rendering, and renders one object
- * at a time.
+ * at a time. The rasterization and shading can optionally be split across
+ * multiple threads; see {@link #threadCount}.
  *
  * \ingroup renderers
  */
 class Rasterizer {
 public:
+  int threadCount = 1; /**< The number of threads to render with. If greater
+                          than 1, the triangles of the scene are binned into
+                          screen tiles of {@link #tileSize} pixels, which are
+                          then rasterized and shaded in parallel. The output is
+                          the same regardless of the number of threads, but the
+                          materials' shaders must be safe to call concurrently.
+                        */
+
+  InstructionSet instructionSet =
+      supportedInstructionSet(); /**< The instruction set to test the coverage
+                                    and depth of pixels with. Defaults to the
+                                    most capable one supported by the
+                                    processor, which is also used if the
+                                    specified one is not supported. The output
+                                    is the same for every instruction set. */
+
+  bool frustumCulling =
+      true; /**< Whether to skip the meshes whose bounding volumes are entirely
+               outside the view frustum of the camera. Like {@link
+               #occlusionCulling}, this assumes that the vertex shaders
+               transform the vertex positions with the model-view-projection
+               matrix. */
+
+  bool occlusionCulling =
+      false; /**< Whether to skip the meshes hidden behind occluders (see
+                {@link Mesh#occluder}). If enabled, the occluders are first
+                drawn into a low-resolution {@link OcclusionBuffer}, and every
+                other mesh whose bounding box is entirely behind them is
+                skipped before its vertices are processed. This assumes that
+                the vertex shaders transform the vertex positions with the
+                model-view-projection matrix, like the built-in materials do.
+              */
+
+  StaticBatcher staticBatcher; /**< The batches of the static meshes (see
+                                  {@link Mesh#isStatic}) of the last rendered
+                                  scene, which are reused as long as the
+                                  static meshes do not move. */
+
+  ShadingMode shadingMode =
+      ShadingMode::Forward; /**< How to shade the fragments. With deferred
+                               shading, the meshes are first drawn into a
+                               {@link GBuffer} without running their fragment
+                               shaders, then the fragment shader of the
+                               visible fragment runs once per covered pixel,
+                               so that lighting does not cost more where
+                               meshes overlap. The output is the same, but the
+                               fragments hidden by later ones are never
+                               shaded, even with {@link
+                               Material#earlyDepthTest} disabled. */
+
+  double lightCutoff =
+      0; /**< The intensity below which a point light is considered not to
+            reach a fragment, for tiled light culling. If positive, every
+            point light is only passed to the fragment shaders of the screen
+            tiles within its influence radius (see {@link LightGrid}), so that
+            the cost of lighting depends on the number of lights near the
+            fragments rather than in the scene. Every light that is skipped
+            would have added at most the cutoff to the color of the
+            fragments of the built-in materials; see {@link
+            LightGrid#influenceRadius}. */
+
+  bool sortMeshes =
+      true; /**< Whether to draw the meshes front to back, then by material,
+               rather than in the order of the scene graph. Drawing the
+               nearest meshes first lets the depth test reject the fragments
+               they hide before they are shaded. Only the meshes whose
+               materials test and write depth are reordered; the others keep
+               their place in the order. */
+
+  FrameArena frameArena; /**< The memory that the scratch buffers of a
+                            render, such as the draw calls, the transformed
+                            vertices, and the bins of the screen tiles, are
+                            allocated from. It is reset when a render starts;
+                            its peak usage (see {@link
+                            FrameArena#peakUsage}) can be reserved up front. */
+
+  RenderStats stats; /**< The statistics of the last render. */
+
+  /**
+   * The width and height of a screen tile, in pixels, when rendering with
+   * multiple threads.
+   */
+  static constexpr int tileSize = 64;
+
+  /**
+   * The extent of the guard band in normalized device coordinates. Triangles
+   * are only clipped against the left, right, bottom, and top planes when they
+   * extend beyond \f$[-g, g]\f$ where \f$g\f$ is this value; otherwise, the
+   * rasterizer simply skips their pixels outside the render target.
+   */
+  static constexpr double guardBand = 16;
+
   /**
    * Renders the given scene using the given camera to the given render target.
    *
+   * The static meshes of the scene that share a material are drawn together
+   * from the batches of {@link #staticBatcher}.
+   *
    * @param scene The scene to render.
    * @param camera The camera to render the scene with a.k.a. the active camera.
    * @param renderTarget The render target i.e. texture to render the scene to.
@@ -38,24 +163,14 @@ public:
   template <class BufferType>
   void render(Scene &scene, Camera &camera,
               RenderTarget<BufferType> &renderTarget) {
-    RenderTarget<double> depthTexture(renderTarget.texture.width,
-                                      renderTarget.texture.height,
-                                      TextureFormat::Depth);
-    // Clear the depth texture and the render target
-
-    for (int i = 0; i < renderTarget.width * renderTarget.height; ++i) {
-      depthTexture.texture.image[i] = 2; // NDC Z ranges from -1 to 1
-      renderTarget.texture.image[i * 3] = 0;
-      renderTarget.texture.image[i * 3 + 1] = 0;
-      renderTarget.texture.image[i * 3 + 2] = 0;
-    }
-
     // Traverse the 3D scene tree and update the local and world matrices
 
-    std::vector<std::reference_wrapper<Mesh>> meshes;
-    std::vector<std::reference_wrapper<Light>> lights;
-    std::stack<std::reference_wrapper<Object3D>> objects;
+    auto &meshes = context.meshes;
+    auto &lights = context.lights;
+    auto &objects = context.objects;
 
+    meshes.clear();
+    lights.clear();
     objects.push(scene);
 
     while (!objects.empty()) {
@@ -80,6 +195,114 @@ public:
       }
     }
 
+    staticBatcher.apply(meshes);
+
+    draw(meshes, lights, std::nullopt, camera, renderTarget);
+  }
+
+  /**
+   * Renders the scene of the given BVH using the given camera to the given
+   * render target.
+   *
+   * Instead of traversing the scene graph, the meshes are culled through the
+   * BVH, whose matrices must be up to date (see {@link SceneBvh#update}). Only
+   * the matrices of the camera and the lights are updated. The meshes may be
+   * drawn in a different order than with {@link #render(Scene &, Camera &,
+   * RenderTarget<BufferType> &)}, which only matters where they overlap at
+   * equal depths.
+   *
+   * @param sceneBvh The BVH of the scene to render.
+   * @param camera The camera to render the scene with a.k.a. the active camera.
+   * @param renderTarget The render target i.e. texture to render the scene to.
+   */
+  template <class BufferType>
+  void render(SceneBvh &sceneBvh, Camera &camera,
+              RenderTarget<BufferType> &renderTarget) {
+    camera.updateLocalMatrix();
+    camera.updateModelMatrix();
+
+    for (Light &light : sceneBvh.lights) {
+      light.updateLocalMatrix();
+      light.updateModelMatrix();
+    }
+
+    auto &meshes = context.meshes;
+
+    meshes.clear();
+    draw(meshes, sceneBvh.lights, sceneBvh, camera, renderTarget);
+  }
+
+  /**
+   * Renders the objects of the given flattened hierarchy using the given
+   * camera to the given render target.
+   *
+   * Instead of traversing the scene graph, the matrices are updated through
+   * the hierarchy (see {@link TransformHierarchy#update}), with {@link
+   * #threadCount} threads. The output is the same as with {@link
+   * #render(Scene &, Camera &, RenderTarget<BufferType> &)}.
+   *
+   * @param hierarchy The flattened hierarchy of the scene to render.
+   * @param camera The camera to render the scene with a.k.a. the active camera.
+   * @param renderTarget The render target i.e. texture to render the scene to.
+   */
+  template <class BufferType>
+  void render(TransformHierarchy &hierarchy, Camera &camera,
+              RenderTarget<BufferType> &renderTarget) {
+    hierarchy.update(workerPool());
+
+    // The camera may not be part of the hierarchy
+
+    camera.updateLocalMatrix();
+    camera.updateModelMatrix();
+
+    auto &meshes = context.meshes;
+
+    meshes.assign(hierarchy.meshes.begin(), hierarchy.meshes.end());
+    staticBatcher.apply(meshes);
+
+    draw(meshes, hierarchy.lights, std::nullopt, camera, renderTarget);
+  }
+
+private:
+  /**
+   * Culls and draws the given meshes, or the meshes of the given BVH.
+   */
+  template <class BufferType>
+  void draw(std::vector<std::reference_wrapper<Mesh>> &meshes,
+            std::vector<std::reference_wrapper<Light>> &lights,
+            std::optional<std::reference_wrapper<SceneBvh>> sceneBvh,
+            Camera &camera, RenderTarget<BufferType> &renderTarget) {
+    stats = RenderStats();
+    frameArena.reset();
+
+    // The buffers of the previous frame are reused, unless the size of the
+    // render target changed
+
+    if (!context.depthTexture ||
+        context.depthTexture->width != renderTarget.width ||
+        context.depthTexture->height != renderTarget.height) {
+      context.depthTexture.emplace(renderTarget.width, renderTarget.height,
+                                   TextureFormat::Depth);
+      context.hierarchicalDepth.emplace(context.depthTexture.value(), 2);
+      context.occlusionBuffer.reset();
+      context.gBuffer.reset();
+      context.lightGrid.reset();
+    } else {
+      context.hierarchicalDepth->clear(2);
+    }
+
+    auto &depthTexture = context.depthTexture.value();
+    auto &hierarchicalDepth = context.hierarchicalDepth.value();
+
+    // Clear the depth texture and the render target
+
+    for (int i = 0; i < renderTarget.width * renderTarget.height; ++i) {
+      depthTexture.texture.image[i] = 2; // NDC Z ranges from -1 to 1
+      renderTarget.texture.image[i * 3] = 0;
+      renderTarget.texture.image[i * 3 + 1] = 0;
+      renderTarget.texture.image[i * 3 + 2] = 0;
+    }
+
     const auto cameraWorldPosHomo =
         camera.modelMatrix * Vector4(camera.localPosition, 1);
     auto cameraWorldPos = Vector3(cameraWorldPosHomo.x / cameraWorldPosHomo.w,
@@ -119,201 +342,1533 @@ public:
     );
     // clang-format on
 
-    // Draw the meshes; one mesh per "draw call".
+    // Draw the meshes; one mesh per "draw call". With a single thread, every
+    // triangle is rasterized as soon as it is set up. With multiple threads,
+    // the triangles are set up first and rasterized tile by tile afterwards.
 
-    for (Mesh &mesh : meshes) {
-      auto geometry = mesh.geometry;
-      auto modelViewMatrix = viewMatrix * mesh.modelMatrix;
-      auto normalMatrix =
-          mesh.modelMatrix.topLeft3x3Matrix().inverse().transpose();
-
-      if (geometry.faceIndices) {
-        for (int i = 0; i < geometry.faceIndices.value().array.size(); i += 3) {
-          const int vertexAIndex = geometry.faceIndices.value().array.at(i);
-          const int vertexBIndex = geometry.faceIndices.value().array.at(i + 1);
-          const int vertexCIndex = geometry.faceIndices.value().array.at(i + 2);
-
-          processTriangle(vertexAIndex, vertexBIndex, vertexCIndex, geometry,
-                          mesh, modelViewMatrix, camera, viewMatrix,
-                          normalMatrix, cameraWorldPos, viewportMatrix, lights,
-                          renderTarget, depthTexture);
-        }
+    GBuffer *gBuffer = nullptr;
+
+    if (shadingMode == ShadingMode::Deferred) {
+      if (context.gBuffer) {
+        context.gBuffer->clear();
+      } else {
+        context.gBuffer.emplace(renderTarget.width, renderTarget.height);
+      }
+
+      gBuffer = &context.gBuffer.value();
+    }
+
+    // Resolve the lights once for the whole frame, rather than in the
+    // fragment shaders
+
+    auto &frameLights = context.frameLights;
+    frameLights.clear();
+
+    for (Light &light : lights) {
+      frameLights.add(light);
+    }
+
+    // With light culling, bin the lights into screen tiles
+
+    LightGrid *lightGrid = nullptr;
+
+    if (lightCutoff > 0) {
+      if (!context.lightGrid) {
+        context.lightGrid.emplace(renderTarget.width, renderTarget.height);
+      }
+
+      lightGrid = &context.lightGrid.value();
+      lightGrid->assign(frameLights, viewMatrix, camera.projectionMatrix,
+                        viewportMatrix, lightCutoff);
+    }
+
+    std::pmr::vector<DrawCall> drawCalls(&frameArena);
+    std::pmr::vector<RasterTriangle> triangles(&frameArena);
+    std::pmr::vector<ClipVertex> transformedVertices(&frameArena);
+
+    Frame frame{camera,
+                viewMatrix,
+                cameraWorldPos,
+                viewportMatrix,
+                frameLights,
+                drawCalls,
+                selectSpanKernel(instructionSet),
+                gBuffer,
+                lightGrid};
+
+    // Test the bounding volumes of the meshes against the view frustum before
+    // any per-triangle work. With a BVH, whole subtrees outside the frustum
+    // are skipped.
+
+    const auto viewProjectionMatrix = camera.projectionMatrix * viewMatrix;
+    const auto frustum = Frustum::fromMatrix(viewProjectionMatrix);
+
+    if (sceneBvh) {
+      sceneBvh->get().traverse(
+          [&](const BoundingBox &boundingBox) {
+            return !frustumCulling || frustum.intersectsBox(boundingBox);
+          },
+          [&](Mesh &mesh) {
+            if (!frustumCulling || !isOutsideFrustum(mesh, frustum)) {
+              meshes.push_back(mesh);
+            }
+          });
+
+      stats.culledMeshes =
+          sceneBvh->get().meshCount() - static_cast<int>(meshes.size());
+    } else if (frustumCulling) {
+      const auto culledMeshes = std::remove_if(
+          meshes.begin(), meshes.end(),
+          [&](Mesh &mesh) { return isOutsideFrustum(mesh, frustum); });
+
+      stats.culledMeshes = static_cast<int>(meshes.end() - culledMeshes);
+      meshes.erase(culledMeshes, meshes.end());
+    }
+
+    // With occlusion culling, draw the occluders into a low-resolution depth
+    // buffer first, which the other meshes' bounding boxes are tested against.
+    // Materials without depth testing may write farther depths over the
+    // occluders, so they turn occlusion culling off.
+
+    const auto occludersAreFinal =
+        std::none_of(meshes.begin(), meshes.end(), [](const Mesh &mesh) {
+          return !mesh.material.depthTest && mesh.material.depthWrite;
+        });
+
+    if (occlusionCulling && occludersAreFinal) {
+      if (context.occlusionBuffer) {
+        context.occlusionBuffer->clear(2);
       } else {
-        for (int i = 0; i < geometry.vertexPositions.array.size() / 3; i += 3) {
-          processTriangle(i, i + 1, i + 2, geometry, mesh, modelViewMatrix,
-                          camera, viewMatrix, normalMatrix, cameraWorldPos,
-                          viewportMatrix, lights, renderTarget, depthTexture);
+        context.occlusionBuffer.emplace(renderTarget.width,
+                                        renderTarget.height, 2);
+      }
+
+      auto &occlusionBuffer = context.occlusionBuffer.value();
+
+      for (Mesh &mesh : meshes) {
+        if (mesh.occluder && mesh.material.depthWrite) {
+          drawOccluder(mesh, frame, frustum, occlusionBuffer,
+                       transformedVertices);
         }
       }
+
+      const auto isMeshOccluded = [&](Mesh &mesh) {
+        return !mesh.occluder &&
+               isOccluded(mesh, frame, occlusionBuffer, renderTarget.width,
+                          renderTarget.height);
+      };
+
+      // Subtrees of the BVH can only be hidden as a whole if all the visible
+      // meshes are depth tested; see isOccluded
+
+      const auto allDepthTested =
+          std::all_of(meshes.begin(), meshes.end(),
+                      [](const Mesh &mesh) { return mesh.material.depthTest; });
+
+      const auto visibleCount = static_cast<int>(meshes.size());
+
+      if (sceneBvh && allDepthTested) {
+        meshes.clear();
+
+        sceneBvh->get().traverse(
+            [&](const BoundingBox &boundingBox) {
+              return (!frustumCulling || frustum.intersectsBox(boundingBox)) &&
+                     !isOccluded(boundingBox, viewProjectionMatrix, frame,
+                                 occlusionBuffer, renderTarget.width,
+                                 renderTarget.height);
+            },
+            [&](Mesh &mesh) {
+              if ((!frustumCulling || !isOutsideFrustum(mesh, frustum)) &&
+                  !isMeshOccluded(mesh)) {
+                meshes.push_back(mesh);
+              }
+            });
+      } else {
+        meshes.erase(
+            std::remove_if(meshes.begin(), meshes.end(), isMeshOccluded),
+            meshes.end());
+      }
+
+      stats.occludedMeshes = visibleCount - static_cast<int>(meshes.size());
+    }
+
+    if (sortMeshes) {
+      sortFrontToBack(meshes, viewMatrix);
+    }
+
+    // An instanced mesh is a single draw call, in which the geometry is
+    // transformed and rasterized once for every visible instance
+
+    for (Mesh &mesh : meshes) {
+      stats.drawCalls++;
+
+      forEachInstance(mesh, frustum, [&](const Matrix4x4 &modelMatrix,
+                                         std::optional<Color> color) {
+        auto &drawCall =
+            drawCalls.emplace_back(mesh, modelMatrix, frame, color);
+        drawCall.index = static_cast<int>(drawCalls.size()) - 1;
+
+        const auto uniforms = drawCall.uniforms(frame);
+
+        // Run the vertex shader once for every vertex of the geometry, then
+        // assemble the triangles from the transformed vertices. This way, a
+        // vertex shared by several triangles of an indexed geometry is only
+        // shaded once.
+
+        shadeVertices(drawCall, uniforms, transformedVertices);
+
+        forEachTriangle(drawCall.geometry, [&](int vertexAIndex,
+                                               int vertexBIndex,
+                                               int vertexCIndex) {
+          const auto polygon = clipTriangle(transformedVertices[vertexAIndex],
+                                            transformedVertices[vertexBIndex],
+                                            transformedVertices[vertexCIndex]);
+
+          stats.triangles++;
+
+          // Triangulate the clipped polygon as a fan
+
+          for (int i = 1; i + 1 < polygon.vertexCount; i++) {
+            auto triangle = setupTriangle(
+                polygon.vertices[0], polygon.vertices[i],
+                polygon.vertices[i + 1], drawCall, frame, renderTarget.width,
+                renderTarget.height);
+
+            if (!triangle) {
+              continue;
+            }
+
+            stats.rasterizedTriangles++;
+
+            if (threadCount > 1) {
+              triangles.push_back(triangle.value());
+            } else {
+              stats.fragmentShaderInvocations += rasterizeTriangle(
+                  triangle.value(), triangle->minX, triangle->maxX,
+                  triangle->minY, triangle->maxY, frame, renderTarget,
+                  depthTexture, hierarchicalDepth);
+            }
+          }
+        });
+      });
+    }
+
+    if (threadCount > 1) {
+      stats.fragmentShaderInvocations +=
+          renderTiles(triangles, frame, renderTarget, depthTexture,
+                      hierarchicalDepth);
+    }
+
+    if (gBuffer) {
+      stats.fragmentShaderInvocations +=
+          shadeGBuffer(*gBuffer, drawCalls, frame, renderTarget);
     }
+
+    stats.scratchMemory = frameArena.used();
   }
 
-private:
-  template <class BufferType>
-  void processTriangle(int vertexAIndex, int vertexBIndex, int vertexCIndex,
-                       Geometry &geometry, Mesh &mesh,
-                       Matrix4x4 &modelViewMatrix, Camera &camera,
-                       Matrix4x4 &viewMatrix, Matrix3x3 &normalMatrix,
-                       Vector3 &cameraPosition, Matrix4x4 &viewportMatrix,
-                       std::vector<std::reference_wrapper<Light>> &lights,
-                       RenderTarget<BufferType> &renderTarget,
-                       RenderTarget<double> &depthTexture) {
-    auto localVertexA =
-        Vector3::fromBufferAttribute(geometry.vertexPositions, vertexAIndex);
-    auto localVertexB =
-        Vector3::fromBufferAttribute(geometry.vertexPositions, vertexBIndex);
-    auto localVertexC =
-        Vector3::fromBufferAttribute(geometry.vertexPositions, vertexCIndex);
-
-    auto vertexANormal =
-        Vector3::fromBufferAttribute(geometry.vertexNormals, vertexAIndex);
-    auto vertexBNormal =
-        Vector3::fromBufferAttribute(geometry.vertexNormals, vertexBIndex);
-    auto vertexCNormal =
-        Vector3::fromBufferAttribute(geometry.vertexNormals, vertexCIndex);
-
-    Uniforms uniforms{
-        mesh.modelMatrix, modelViewMatrix, camera.projectionMatrix,
-        viewMatrix,       normalMatrix,    cameraPosition};
-    Attributes attributes{localVertexA, vertexANormal};
-    Varyings varyingsVertexA = {localVertexA, vertexANormal};
-    Varyings varyingsVertexB = {localVertexB, vertexBNormal};
-    Varyings varyingsVertexC = {localVertexC, vertexCNormal};
-
-    const auto transformedVertexA =
-        mesh.material.vertexShader(uniforms, attributes);
-
-    attributes.localPosition = localVertexB;
-    attributes.localNormal = vertexBNormal;
-    const auto transformedVertexB =
-        mesh.material.vertexShader(uniforms, attributes);
-
-    attributes.localPosition = localVertexC;
-    attributes.localNormal = vertexCNormal;
-    const auto transformedVertexC =
-        mesh.material.vertexShader(uniforms, attributes);
-
-    auto screenSpaceVertexA = viewportMatrix * transformedVertexA;
-    auto screenSpaceVertexB = viewportMatrix * transformedVertexB;
-    auto screenSpaceVertexC = viewportMatrix * transformedVertexC;
+  /**
+   * The number of values interpolated across a triangle: the depth, 1/w, and
+   * the 6 components of the {@link Varyings} divided by w.
+   */
+  static constexpr int interpolantCount = 8;
 
-    screenSpaceVertexA /= screenSpaceVertexA.w;
-    screenSpaceVertexA.w = 1.0 / transformedVertexA.w;
-    screenSpaceVertexB /= screenSpaceVertexB.w;
-    screenSpaceVertexB.w = 1.0 / transformedVertexB.w;
-    screenSpaceVertexC /= screenSpaceVertexC.w;
-    screenSpaceVertexC.w = 1.0 / transformedVertexC.w;
+  // Spans and blocks of the hierarchical depth buffer must not straddle tiles,
+  // and spans must not straddle blocks
 
-    const auto clockwiseMatrix = Matrix3x3(
-        screenSpaceVertexA.x, screenSpaceVertexA.y, 1, screenSpaceVertexB.x,
-        screenSpaceVertexB.y, 1, screenSpaceVertexC.x, screenSpaceVertexC.y, 1);
+  static_assert(tileSize % spanWidth == 0);
+  static_assert(tileSize % HierarchicalDepthBuffer::blockSize == 0);
+  static_assert(HierarchicalDepthBuffer::blockSize % spanWidth == 0);
 
-    if (clockwiseMatrix.determinant() *
-            static_cast<int>(mesh.geometry.frontFace) *
-            static_cast<int>(mesh.material.cullMode) <
-        0) {
-      return;
+  // The fragments of a span are shaded as one batch, and the batches of
+  // deferred shading, which are aligned like spans, must not straddle the
+  // tiles of the light grid
+
+  static_assert(spanWidth <= FragmentBatch::capacity);
+  static_assert(LightGrid::tileSize % FragmentBatch::capacity == 0);
+
+  /**
+   * The tolerance for rounding errors when comparing the range of depths of a
+   * triangle, computed from its vertices, with the hierarchical depth buffer.
+   */
+  static constexpr double depthTolerance = 1e-6;
+
+  struct DrawCall;
+
+  /**
+   * The per-frame state shared by all draw calls.
+   */
+  struct Frame {
+    Camera &camera;
+    Matrix4x4 viewMatrix;
+    Vector3 cameraPosition;
+    Matrix4x4 viewportMatrix;
+    LightList &lights; // Resolved for the frame
+    std::pmr::vector<DrawCall> &drawCalls; // In the order they are issued
+    SpanKernel spanKernel;
+    GBuffer *gBuffer; // With deferred shading; null with forward shading
+    LightGrid *lightGrid; // With light culling; null otherwise
+
+    /**
+     * Returns the lights that may light the fragment at a pixel.
+     */
+    const LightList &lightsAt(int x, int y) const {
+      return lightGrid ? lightGrid->lightsAt(x, y) : lights;
     }
+  };
 
-    const auto maxY = static_cast<int>(std::round(
-        std::max(std::max(screenSpaceVertexA.y, screenSpaceVertexB.y),
-                 screenSpaceVertexC.y)));
-    const auto minY = static_cast<int>(std::round(
-        std::min(std::min(screenSpaceVertexA.y, screenSpaceVertexB.y),
-                 screenSpaceVertexC.y)));
-    const auto yDiff = maxY - minY;
-
-    std::vector<std::set<Fragment>> fragments(yDiff + 1);
-
-    const auto bresenhamAB =
-        bresenham(static_cast<int>(std::round(screenSpaceVertexA.x)),
-                  static_cast<int>(std::round(screenSpaceVertexA.y)),
-                  static_cast<int>(std::round(screenSpaceVertexB.x)),
-                  static_cast<int>(std::round(screenSpaceVertexB.y)));
-    const auto bresenhamBC =
-        bresenham(static_cast<int>(std::round(screenSpaceVertexB.x)),
-                  static_cast<int>(std::round(screenSpaceVertexB.y)),
-                  static_cast<int>(std::round(screenSpaceVertexC.x)),
-                  static_cast<int>(std::round(screenSpaceVertexC.y)));
-    const auto bresenhamCA =
-        bresenham(static_cast<int>(std::round(screenSpaceVertexC.x)),
-                  static_cast<int>(std::round(screenSpaceVertexC.y)),
-                  static_cast<int>(std::round(screenSpaceVertexA.x)),
-                  static_cast<int>(std::round(screenSpaceVertexA.y)));
-
-    for (auto [x, y] : bresenhamAB) {
-      fragments[y - minY].insert(Fragment{x, y});
-    }
-
-    for (auto [x, y] : bresenhamBC) {
-      fragments[y - minY].insert(Fragment{x, y});
-    }
-
-    for (auto [x, y] : bresenhamCA) {
-      fragments[y - minY].insert(Fragment{x, y});
-    }
-
-    for (auto &line : fragments) {
-      auto startFragment = line.begin();
-      auto endFragment = std::next(startFragment);
-
-      const auto y = startFragment->y;
-
-      while (endFragment != line.end()) {
-        for (int x = startFragment->x; x <= endFragment->x; x++) {
-          const auto bary = barycentric(
-              Vector3(x, y, 0),
-              Vector3(screenSpaceVertexA.x, screenSpaceVertexA.y, 0),
-              Vector3(screenSpaceVertexB.x, screenSpaceVertexB.y, 0),
-              Vector3(screenSpaceVertexC.x, screenSpaceVertexC.y, 0));
-
-          const auto perspectiveBary =
-              Vector3(bary.x * screenSpaceVertexA.w,
-                      bary.y * screenSpaceVertexB.w,
-                      bary.z * screenSpaceVertexC.w) /
-              (bary.x * screenSpaceVertexA.w + bary.y * screenSpaceVertexB.w +
-               bary.z * screenSpaceVertexC.w);
-
-          Vector3 localPosition =
-              varyingsVertexA.localPosition * perspectiveBary.x +
-              varyingsVertexB.localPosition * perspectiveBary.y +
-              varyingsVertexC.localPosition * perspectiveBary.z;
-          Vector3 localNormal =
-              varyingsVertexA.localNormal * perspectiveBary.x +
-              varyingsVertexB.localNormal * perspectiveBary.y +
-              varyingsVertexC.localNormal * perspectiveBary.z;
-
-          Varyings varyings = {localPosition, localNormal};
-
-          Color color =
-              mesh.material.fragmentShader(uniforms, varyings, lights);
-
-          // Clip vertices outside of the screen space
-
-          if (x < 0 || x >= renderTarget.width || y < 0 ||
-              y >= renderTarget.height) {
-            continue;
-          }
+  /**
+   * A pointer to a material, to one of the built-in materials if that is its
+   * exact type, so that visiting it calls code specialized for that material.
+   * Other materials, including those derived from the built-in ones, are
+   * shaded through their virtual functions.
+   */
+  using MaterialVariant =
+      std::variant<Material *, BlinnPhong *, NormalColor *, SolidColor *>;
+
+  /**
+   * Returns a pointer to a material as the most specific alternative of
+   * {@link MaterialVariant} that it matches exactly.
+   */
+  static MaterialVariant resolveMaterial(Material &material) {
+    const auto &type = typeid(material);
+
+    if (type == typeid(BlinnPhong)) {
+      return static_cast<BlinnPhong *>(&material);
+    }
 
-          const double z = bary.x * screenSpaceVertexA.z +
-                           bary.y * screenSpaceVertexB.z +
-                           bary.z * screenSpaceVertexC.z;
+    if (type == typeid(NormalColor)) {
+      return static_cast<NormalColor *>(&material);
+    }
 
-          const auto currentDepth = depthTexture.read(x, y).x;
+    if (type == typeid(SolidColor)) {
+      return static_cast<SolidColor *>(&material);
+    }
 
-          if (!(mesh.material.depthTest ^ (z <= currentDepth))) {
-            renderTarget.write(x, y, color);
-            if (mesh.material.depthWrite) {
-              depthTexture.write(x, y, Color(z, 0.0, 0.0));
-            }
+    return &material;
+  }
+
+  /**
+   * Runs the vertex shader of a material, without virtual dispatch if the
+   * type of the material is one of the built-in materials.
+   */
+  template <class MaterialType>
+  static Vector4 vertexShader(MaterialType &material, const Uniforms &uniforms,
+                              const Attributes &attributes) {
+    if constexpr (std::is_same_v<MaterialType, Material>) {
+      return material.vertexShader(uniforms, attributes);
+    } else {
+      return material.MaterialType::vertexShader(uniforms, attributes);
+    }
+  }
+
+  /**
+   * Runs the fragment shader of a material for a batch of fragments, without
+   * virtual dispatch if the type of the material is one of the built-in
+   * materials.
+   */
+  template <class MaterialType>
+  static void shadeFragments(MaterialType &material, const Uniforms &uniforms,
+                             FragmentBatch &fragments,
+                             const LightList &lights) {
+    if constexpr (std::is_same_v<MaterialType, Material>) {
+      material.shadeFragments(uniforms, fragments, lights);
+    } else {
+      material.MaterialType::shadeFragments(uniforms, fragments, lights);
+    }
+  }
+
+  /**
+   * The state of the draw call of a single mesh.
+   */
+  struct DrawCall {
+    Mesh &mesh;
+    MaterialVariant material; // The material of the mesh, resolved once
+    Geometry &geometry; // The geometry of the mesh or one of its levels
+    Matrix4x4 modelMatrix;
+    Matrix4x4 modelViewMatrix;
+    Matrix3x3 normalMatrix; // Cached by the mesh, except for instances
+    std::optional<Color> color; // The color of the instance, if any
+    int index = -1; // The index of the draw call in the frame
+
+    DrawCall(Mesh &_mesh, const Matrix4x4 &_modelMatrix, Frame &frame,
+             std::optional<Color> _color)
+        : mesh(_mesh), material(resolveMaterial(_mesh.material)),
+          geometry(selectGeometry(_mesh, _modelMatrix, frame)),
+          modelMatrix(_modelMatrix),
+          modelViewMatrix(frame.viewMatrix * _modelMatrix),
+          normalMatrix(
+              _mesh.isInstancedMesh()
+                  ? _modelMatrix.topLeft3x3Matrix().inverse().transpose()
+                  : _mesh.normalMatrix),
+          color(_color) {}
+
+    Uniforms uniforms(Frame &frame) {
+      return Uniforms{modelMatrix,         modelViewMatrix,
+                      frame.camera.projectionMatrix, frame.viewMatrix,
+                      normalMatrix,        frame.cameraPosition};
+    }
+  };
+
+  /**
+   * The maximum number of vertices of a triangle clipped against the near,
+   * far, and guard-band planes: every plane can add at most one vertex.
+   */
+  static constexpr int maxClippedVertexCount = 3 + 6;
+
+  /**
+   * A vertex in clip space, as output by the vertex shader, along with its
+   * varyings.
+   */
+  struct ClipVertex {
+    Vector4 position = Vector4(0, 0, 0, 1);
+    Vector3 localPosition = Vector3(0, 0, 0);
+    Vector3 localNormal = Vector3(0, 0, 0);
+
+    /**
+     * Linearly interpolates between this vertex and another vertex in clip
+     * space.
+     */
+    ClipVertex lerp(const ClipVertex &other, double t) const {
+      return ClipVertex{position + (other.position - position) * t,
+                        localPosition + (other.localPosition - localPosition) * t,
+                        localNormal + (other.localNormal - localNormal) * t};
+    }
+  };
+
+  /**
+   * A convex polygon resulting from clipping a triangle.
+   */
+  struct ClippedPolygon {
+    std::array<ClipVertex, maxClippedVertexCount> vertices;
+    int vertexCount = 0;
+  };
+
+  /**
+   * Runs the vertex shader of a draw call's material on one of the vertices of
+   * its geometry.
+   */
+  template <class MaterialType>
+  static ClipVertex shadeVertex(int index, MaterialType &material,
+                                const DrawCall &drawCall,
+                                const Uniforms &uniforms) {
+    auto localPosition =
+        Vector3::fromBufferAttribute(drawCall.geometry.vertexPositions, index);
+    auto localNormal =
+        Vector3::fromBufferAttribute(drawCall.geometry.vertexNormals, index);
+
+    return ClipVertex{vertexShader(material, uniforms,
+                                   Attributes{localPosition, localNormal}),
+                      localPosition, localNormal};
+  }
+
+  /**
+   * Returns the signed distance of a vertex in clip space to one of the clip
+   * planes. The vertex is inside the plane if the distance is non-negative.
+   *
+   * The planes are, in order: near, far, left, right, bottom, and top. The
+   * near and far planes are those of the view frustum, whereas the left,
+   * right, bottom, and top planes are those of the guard band.
+   */
+  static double clipDistance(const Vector4 &position, int plane) {
+    switch (plane) {
+    case 0:
+      return position.z + position.w;
+    case 1:
+      return position.w - position.z;
+    case 2:
+      return guardBand * position.w + position.x;
+    case 3:
+      return guardBand * position.w - position.x;
+    case 4:
+      return guardBand * position.w + position.y;
+    default:
+      return guardBand * position.w - position.y;
+    }
+  }
+
+  /**
+   * Clips a triangle in clip space against the near and far planes of the
+   * view frustum and against the guard band.
+   *
+   * Triangles entirely outside one of the view frustum's planes are rejected.
+   * Triangles that cross the left, right, bottom, or top planes of the view
+   * frustum but stay within the guard band are not clipped; the rasterizer
+   * only walks their pixels inside the render target.
+   *
+   * @returns The clipped convex polygon, which has no vertices if the triangle
+   * is rejected.
+   */
+  static ClippedPolygon clipTriangle(const ClipVertex &vertexA,
+                                     const ClipVertex &vertexB,
+                                     const ClipVertex &vertexC) {
+    ClippedPolygon polygon;
+
+    // Trivially reject the triangle if all of its vertices are outside the
+    // same plane of the view frustum
+
+    const auto outcode = [](const Vector4 &p) {
+      return (p.x < -p.w) | (p.x > p.w) << 1 | (p.y < -p.w) << 2 |
+             (p.y > p.w) << 3 | (p.z < -p.w) << 4 | (p.z > p.w) << 5;
+    };
+
+    if (outcode(vertexA.position) & outcode(vertexB.position) &
+        outcode(vertexC.position)) {
+      return polygon;
+    }
+
+    polygon.vertices[0] = vertexA;
+    polygon.vertices[1] = vertexB;
+    polygon.vertices[2] = vertexC;
+    polygon.vertexCount = 3;
+
+    // Clip the polygon against the planes it crosses, one plane at a time
+    // (Sutherland–Hodgman). New vertices are always interpolated from the
+    // inside vertex towards the outside one, so that an edge shared by two
+    // triangles is clipped at exactly the same point for both.
+
+    for (int plane = 0; plane < 6; plane++) {
+      std::array<double, maxClippedVertexCount> distances;
+      bool crossesPlane = false;
+
+      for (int i = 0; i < polygon.vertexCount; i++) {
+        distances[i] = clipDistance(polygon.vertices[i].position, plane);
+        crossesPlane |= distances[i] < 0;
+      }
+
+      if (!crossesPlane) {
+        continue;
+      }
+
+      ClippedPolygon clipped;
+
+      for (int i = 0; i < polygon.vertexCount; i++) {
+        const auto j = (i + 1) % polygon.vertexCount;
+        const auto &current = polygon.vertices[i];
+        const auto &next = polygon.vertices[j];
+
+        if (distances[i] >= 0) {
+          clipped.vertices[clipped.vertexCount++] = current;
+
+          if (distances[j] < 0) {
+            clipped.vertices[clipped.vertexCount++] = current.lerp(
+                next, distances[i] / (distances[i] - distances[j]));
           }
+        } else if (distances[j] >= 0) {
+          clipped.vertices[clipped.vertexCount++] = next.lerp(
+              current, distances[j] / (distances[j] - distances[i]));
         }
+      }
+
+      polygon = clipped;
+
+      if (polygon.vertexCount < 3) {
+        polygon.vertexCount = 0;
+        break;
+      }
+    }
+
+    return polygon;
+  }
+
+  /**
+   * Runs the vertex shader of a draw call for every vertex of its geometry.
+   */
+  void shadeVertices(const DrawCall &drawCall, const Uniforms &uniforms,
+                     std::pmr::vector<ClipVertex> &vertices) {
+    const auto vertexCount =
+        static_cast<int>(drawCall.geometry.vertexPositions.array.size() / 3);
+
+    vertices.clear();
+
+    std::visit(
+        [&](auto *material) {
+          for (int i = 0; i < vertexCount; i++) {
+            vertices.push_back(shadeVertex(i, *material, drawCall, uniforms));
+          }
+        },
+        drawCall.material);
+
+    stats.vertexShaderInvocations += vertexCount;
+  }
+
+  /**
+   * Calls a function with the vertex indices of every triangle of a geometry,
+   * indexed or not.
+   */
+  template <class Function>
+  static void forEachTriangle(const Geometry &geometry, Function function) {
+    if (geometry.faceIndices) {
+      const auto &indices = geometry.faceIndices.value().array;
 
-        startFragment = std::next(startFragment);
-        endFragment = std::next(endFragment);
+      for (std::size_t i = 0; i < indices.size(); i += 3) {
+        function(indices[i], indices[i + 1], indices[i + 2]);
+      }
+    } else {
+      const auto vertexCount =
+          static_cast<int>(geometry.vertexPositions.array.size() / 3);
+
+      for (int i = 0; i < vertexCount; i += 3) {
+        function(i, i + 1, i + 2);
       }
     }
   }
+
+  /**
+   * Draws the triangles of an occluder into the occlusion buffer, culling them
+   * the same way as when the occluder is rendered.
+   */
+  void drawOccluder(Mesh &mesh, Frame &frame, const Frustum &frustum,
+                    OcclusionBuffer &occlusionBuffer,
+                    std::pmr::vector<ClipVertex> &vertices) {
+    forEachInstance(mesh, frustum, [&](const Matrix4x4 &modelMatrix,
+                                       std::optional<Color>) {
+      auto drawCall = DrawCall(mesh, modelMatrix, frame, std::nullopt);
+
+      shadeVertices(drawCall, drawCall.uniforms(frame), vertices);
+
+      forEachTriangle(drawCall.geometry, [&](int vertexAIndex,
+                                             int vertexBIndex,
+                                             int vertexCIndex) {
+        const auto polygon =
+            clipTriangle(vertices[vertexAIndex], vertices[vertexBIndex],
+                         vertices[vertexCIndex]);
+
+        const auto toScreenSpace = [&](int index) {
+          auto vertex =
+              frame.viewportMatrix * polygon.vertices[index].position;
+          return vertex /= vertex.w;
+        };
+
+        const auto vertexA = toScreenSpace(0);
+
+        for (int i = 1; i + 1 < polygon.vertexCount; i++) {
+          occlusionBuffer.drawTriangle(
+              vertexA, toScreenSpace(i), toScreenSpace(i + 1),
+              static_cast<int>(drawCall.geometry.frontFace) *
+                  static_cast<int>(mesh.material.cullMode));
+        }
+      });
+    });
+  }
+
+  /**
+   * Calls a function with the model matrix and color of every instance of a
+   * mesh to draw. A mesh that is not an {@link InstancedMesh} is a single
+   * instance without color. With frustum culling, the instances outside the
+   * view frustum are skipped.
+   */
+  template <class Function>
+  void forEachInstance(Mesh &mesh, const Frustum &frustum, Function function) {
+    if (!mesh.isInstancedMesh()) {
+      function(mesh.modelMatrix, std::nullopt);
+      return;
+    }
+
+    auto &instancedMesh = static_cast<InstancedMesh &>(mesh);
+
+    // The bounding volumes of the geometry, rather than of all the instances
+
+    const auto &boundingSphere = instancedMesh.Mesh::localBoundingSphere();
+    const auto &boundingBox = instancedMesh.Mesh::localBoundingBox();
+
+    for (int i = 0; i < instancedMesh.count(); i++) {
+      const auto modelMatrix =
+          instancedMesh.modelMatrix * instancedMesh.instanceMatrices[i];
+
+      if (frustumCulling &&
+          isOutsideFrustum(boundingSphere, boundingBox, modelMatrix, frustum)) {
+        continue;
+      }
+
+      function(modelMatrix, instancedMesh.instanceColors
+                                ? std::optional<Color>(
+                                      instancedMesh.instanceColors.value()[i])
+                                : std::nullopt);
+    }
+  }
+
+  /**
+   * The number of depth buckets that {@link #sortFrontToBack} sorts meshes
+   * into per doubling of the view depth.
+   */
+  static constexpr int depthBucketsPerOctave = 8;
+
+  /**
+   * Sorts meshes by the view depth of the nearest point of their bounding
+   * spheres, then by material, so that meshes with the same material at about
+   * the same depth are drawn one after another.
+   *
+   * The depths are quantized into logarithmic buckets of {@link
+   * #depthBucketsPerOctave} per doubling of the depth, so that the material
+   * decides the order of the meshes within a bucket. The materials are ordered
+   * by their first mesh, and the meshes with the same depth bucket and
+   * material keep their order, so that the order does not depend on where the
+   * materials are in memory.
+   *
+   * The meshes whose materials do not both test and write depth depend on
+   * the order they are drawn in, so they keep their place: only the runs of
+   * meshes between them are sorted.
+   */
+  void sortFrontToBack(std::vector<std::reference_wrapper<Mesh>> &meshes,
+                       const Matrix4x4 &viewMatrix) {
+    const auto isSorted = [](const Mesh &mesh) {
+      return mesh.material.depthTest && mesh.material.depthWrite;
+    };
+
+    const auto depthOf = [&](Mesh &mesh) {
+      const auto boundingSphere =
+          mesh.localBoundingSphere().transform(mesh.modelMatrix);
+
+      if (boundingSphere.isEmpty()) {
+        return 0.0;
+      }
+
+      const auto center = viewMatrix * Vector4(boundingSphere.center, 1);
+
+      return -center.z - boundingSphere.radius; // The camera looks down -Z
+    };
+
+    const auto depthBucketOf = [&](Mesh &mesh) {
+      const auto depth = depthOf(mesh);
+
+      // The meshes around the camera all go into the nearest bucket
+
+      return depth > 0 ? static_cast<int>(std::floor(std::log2(depth) *
+                                                     depthBucketsPerOctave))
+                       : std::numeric_limits<int>::min();
+    };
+
+    const auto meshCount = static_cast<int>(meshes.size());
+    const std::pmr::vector<std::reference_wrapper<Mesh>> unsorted(
+        meshes.begin(), meshes.end(), &frameArena);
+
+    // Number the materials by the index of their first mesh: group the meshes
+    // by material, in any order, then find the first mesh of every group
+
+    std::pmr::vector<std::pair<const Material *, int>> materials(&frameArena);
+    std::pmr::vector<int> materialOrders(meshCount, &frameArena);
+
+    for (int i = 0; i < meshCount; i++) {
+      materials.emplace_back(&unsorted[i].get().material, i);
+    }
+
+    std::sort(materials.begin(), materials.end(),
+              [](const auto &a, const auto &b) {
+                if (a.first != b.first) {
+                  return std::less<const Material *>()(a.first, b.first);
+                }
+
+                return a.second < b.second;
+              });
+
+    for (std::size_t i = 0; i < materials.size(); i++) {
+      const auto isFirst =
+          i == 0 || materials[i].first != materials[i - 1].first;
+      const auto firstMesh = isFirst ? materials[i].second
+                                     : materialOrders[materials[i - 1].second];
+
+      materialOrders[materials[i].second] = firstMesh;
+    }
+
+    std::pmr::vector<SortKey> keys(&frameArena);
+
+    for (int i = 0; i < meshCount; i++) {
+      Mesh &mesh = unsorted[i];
+
+      keys.push_back(
+          {isSorted(mesh) ? depthBucketOf(mesh) : 0, materialOrders[i], i});
+    }
+
+    const auto compare = [](const SortKey &a, const SortKey &b) {
+      if (a.depthBucket != b.depthBucket) {
+        return a.depthBucket < b.depthBucket;
+      }
+
+      if (a.materialOrder != b.materialOrder) {
+        return a.materialOrder < b.materialOrder;
+      }
+
+      return a.index < b.index;
+    };
+
+    for (auto first = keys.begin(); first != keys.end();) {
+      const auto last =
+          std::find_if(first, keys.end(), [&](const SortKey &key) {
+            return !isSorted(unsorted[key.index]);
+          });
+
+      std::sort(first, last, compare);
+      first = last == keys.end() ? last : last + 1;
+    }
+
+    for (std::size_t i = 0; i < keys.size(); i++) {
+      meshes[i] = unsorted[keys[i].index];
+    }
+  }
+
+  /**
+   * The key that {@link #sortFrontToBack} sorts a mesh by.
+   */
+  struct SortKey {
+    int depthBucket;
+    int materialOrder; // The index of the first mesh with the same material
+    int index;         // The index of the mesh before sorting
+  };
+
+  /**
+   * Returns the geometry to draw a mesh with, from the size of its bounding
+   * sphere on the screen; see {@link Mesh#addLevelOfDetail}.
+   */
+  static Geometry &selectGeometry(Mesh &mesh, const Matrix4x4 &modelMatrix,
+                                  Frame &frame) {
+    if (mesh.levelsOfDetail.empty()) {
+      return mesh.geometry;
+    }
+
+    const auto boundingSphere =
+        mesh.Mesh::localBoundingSphere().transform(modelMatrix);
+
+    if (boundingSphere.isEmpty()) {
+      return mesh.geometry;
+    }
+
+    // The radius of the sphere in NDC is its radius scaled by the vertical
+    // scale of the projection, divided by w at its center. NDC spans 2 units
+    // across the render target, so this is also the diameter of the sphere
+    // relative to the height of the render target.
+
+    const auto &projectionMatrix = frame.camera.projectionMatrix;
+    const auto center = projectionMatrix * frame.viewMatrix *
+                        Vector4(boundingSphere.center, 1);
+
+    if (center.w <= 0) {
+      return mesh.geometry; // The center is behind the camera
+    }
+
+    return mesh.geometryForScreenSize(boundingSphere.radius *
+                                      std::abs(projectionMatrix.elements[5]) /
+                                      center.w);
+  }
+
+  /**
+   * Checks whether the bounding volumes of a mesh are entirely outside the
+   * view frustum.
+   */
+  static bool isOutsideFrustum(Mesh &mesh, const Frustum &frustum) {
+    return isOutsideFrustum(mesh.localBoundingSphere(), mesh.localBoundingBox(),
+                            mesh.modelMatrix, frustum);
+  }
+
+  /**
+   * Checks whether bounding volumes, transformed to world space by the
+   * specified model matrix, are entirely outside the view frustum. The
+   * bounding sphere is tested first in world space, then the tighter bounding
+   * box in local space.
+   */
+  static bool isOutsideFrustum(const BoundingSphere &boundingSphere,
+                               const BoundingBox &boundingBox,
+                               const Matrix4x4 &modelMatrix,
+                               const Frustum &frustum) {
+    if (boundingBox.isEmpty()) {
+      return false;
+    }
+
+    if (!frustum.intersectsSphere(boundingSphere.transform(modelMatrix))) {
+      return true;
+    }
+
+    // The planes of the frustum in local space are the planes in world space
+    // transformed by the transpose of the model matrix
+
+    const auto transposedModelMatrix = modelMatrix.transpose();
+    const auto &planes = frustum.planes;
+    const auto localFrustum = Frustum(
+        transposedModelMatrix * planes[0], transposedModelMatrix * planes[1],
+        transposedModelMatrix * planes[2], transposedModelMatrix * planes[3],
+        transposedModelMatrix * planes[4], transposedModelMatrix * planes[5]);
+
+    return !localFrustum.intersectsBox(boundingBox);
+  }
+
+  /**
+   * Checks whether the bounding box of a mesh is entirely hidden behind the
+   * occluders in the occlusion buffer.
+   */
+  bool isOccluded(Mesh &mesh, Frame &frame,
+                  const OcclusionBuffer &occlusionBuffer, int width,
+                  int height) {
+    // Materials without depth testing use an inverted depth test, which
+    // nothing can hide from; see rasterizeTriangle
+
+    if (!mesh.material.depthTest) {
+      return false;
+    }
+
+    return isOccluded(mesh.localBoundingBox(),
+                      frame.camera.projectionMatrix * frame.viewMatrix *
+                          mesh.modelMatrix,
+                      frame, occlusionBuffer, width, height);
+  }
+
+  /**
+   * Checks whether a bounding box, transformed to clip space by the specified
+   * matrix, is entirely hidden behind the occluders in the occlusion buffer.
+   */
+  static bool isOccluded(const BoundingBox &boundingBox,
+                         const Matrix4x4 &modelViewProjectionMatrix,
+                         Frame &frame, const OcclusionBuffer &occlusionBuffer,
+                         int width, int height) {
+    if (boundingBox.isEmpty()) {
+      return false;
+    }
+
+    auto minX = std::numeric_limits<double>::infinity();
+    auto minY = std::numeric_limits<double>::infinity();
+    auto maxX = -std::numeric_limits<double>::infinity();
+    auto maxY = -std::numeric_limits<double>::infinity();
+    auto minDepth = std::numeric_limits<double>::infinity();
+
+    for (const auto &corner : boundingBox.corners()) {
+      const auto clipSpaceCorner =
+          modelViewProjectionMatrix * Vector4(corner, 1);
+
+      // A mesh crossing the near plane cannot be bounded on the screen
+
+      if (clipDistance(clipSpaceCorner, 0) < 0 || clipSpaceCorner.w <= 0) {
+        return false;
+      }
+
+      auto screenSpaceCorner = frame.viewportMatrix * clipSpaceCorner;
+      screenSpaceCorner /= screenSpaceCorner.w;
+
+      minX = std::min(minX, screenSpaceCorner.x);
+      minY = std::min(minY, screenSpaceCorner.y);
+      maxX = std::max(maxX, screenSpaceCorner.x);
+      maxY = std::max(maxY, screenSpaceCorner.y);
+      minDepth = std::min(minDepth, screenSpaceCorner.z);
+    }
+
+    // Off-screen meshes are not occluded
+
+    if (maxX < 0 || maxY < 0 || minX > width - 1 || minY > height - 1) {
+      return false;
+    }
+
+    return occlusionBuffer.isHidden(
+        std::max(static_cast<int>(std::floor(minX)) - 1, 0),
+        std::max(static_cast<int>(std::floor(minY)) - 1, 0),
+        std::min(static_cast<int>(std::ceil(maxX)) + 1, width - 1),
+        std::min(static_cast<int>(std::ceil(maxY)) + 1, height - 1),
+        minDepth - depthTolerance);
+  }
+
+  /**
+   * A triangle that has been transformed to screen space and is ready to be
+   * rasterized.
+   */
+  struct RasterTriangle {
+    int drawCall; // The index of the draw call in the frame
+    std::array<FixedPointEdgeFunction, 3> edges; // Opposite to A, B, and C
+    std::array<PlaneEquation, interpolantCount> planes;
+    int minX; // The bounding box of the triangle, clamped to the render target
+    int maxX;
+    int minY;
+    int maxY;
+    double minDepth; // The range of depths of the vertices
+    double maxDepth;
+  };
+
+  /**
+   * Culls a triangle and sets up its edge functions and plane equations for
+   * rasterization.
+   *
+   * @returns The triangle ready to be rasterized, or nothing if the triangle is
+   * culled or does not cover any pixel.
+   */
+  std::optional<RasterTriangle> setupTriangle(const ClipVertex &vertexA,
+                                              const ClipVertex &vertexB,
+                                              const ClipVertex &vertexC,
+                                              DrawCall &drawCall, Frame &frame,
+                                              int width, int height) {
+    auto &mesh = drawCall.mesh;
+
+    const auto &localVertexA = vertexA.localPosition;
+    const auto &localVertexB = vertexB.localPosition;
+    const auto &localVertexC = vertexC.localPosition;
+    const auto &vertexANormal = vertexA.localNormal;
+    const auto &vertexBNormal = vertexB.localNormal;
+    const auto &vertexCNormal = vertexC.localNormal;
+    const auto &transformedVertexA = vertexA.position;
+    const auto &transformedVertexB = vertexB.position;
+    const auto &transformedVertexC = vertexC.position;
+
+    auto screenSpaceVertexA = frame.viewportMatrix * transformedVertexA;
+    auto screenSpaceVertexB = frame.viewportMatrix * transformedVertexB;
+    auto screenSpaceVertexC = frame.viewportMatrix * transformedVertexC;
+
+    screenSpaceVertexA /= screenSpaceVertexA.w;
+    screenSpaceVertexA.w = 1.0 / transformedVertexA.w;
+    screenSpaceVertexB /= screenSpaceVertexB.w;
+    screenSpaceVertexB.w = 1.0 / transformedVertexB.w;
+    screenSpaceVertexC /= screenSpaceVertexC.w;
+    screenSpaceVertexC.w = 1.0 / transformedVertexC.w;
+
+    // Snap the vertices to fixed-point sub-pixel coordinates, so that the
+    // coverage is computed exactly and does not depend on how the work is
+    // split between threads
+
+    const auto xA = toSubpixel(screenSpaceVertexA.x);
+    const auto yA = toSubpixel(screenSpaceVertexA.y);
+    const auto xB = toSubpixel(screenSpaceVertexB.x);
+    const auto yB = toSubpixel(screenSpaceVertexB.y);
+    const auto xC = toSubpixel(screenSpaceVertexC.x);
+    const auto yC = toSubpixel(screenSpaceVertexC.y);
+
+    auto edgeBC = FixedPointEdgeFunction(xB, yB, xC, yC);
+    auto edgeCA = FixedPointEdgeFunction(xC, yC, xA, yA);
+    auto edgeAB = FixedPointEdgeFunction(xA, yA, xB, yB);
+
+    // The area is the determinant of the vertices' homogeneous coordinates,
+    // positive for counter-clockwise triangles
+
+    const auto area = edgeAB.a * xC + edgeAB.b * yC + edgeAB.c;
+
+    if (area == 0 || area * static_cast<int>(drawCall.geometry.frontFace) *
+                             static_cast<int>(mesh.material.cullMode) <
+                         0) {
+      return std::nullopt;
+    }
+
+    // Find the bounding box of the pixel centers covered by the triangle,
+    // clamped to the render target. Pixel centers are at integer coordinates.
+
+    const auto toPixelCeil = [](std::int64_t subpixel) {
+      return static_cast<int>(-(-subpixel >> subpixelBits));
+    };
+    const auto toPixelFloor = [](std::int64_t subpixel) {
+      return static_cast<int>(subpixel >> subpixelBits);
+    };
+
+    const auto minX = std::max(toPixelCeil(std::min({xA, xB, xC})), 0);
+    const auto maxX = std::min(toPixelFloor(std::max({xA, xB, xC})), width - 1);
+    const auto minY = std::max(toPixelCeil(std::min({yA, yB, yC})), 0);
+    const auto maxY =
+        std::min(toPixelFloor(std::max({yA, yB, yC})), height - 1);
+
+    if (minX > maxX || minY > maxY) {
+      return std::nullopt;
+    }
+
+    // Orient the edges so that the inside of the triangle is positive, then
+    // apply the fill rule
+
+    if (area < 0) {
+      edgeBC.negate();
+      edgeCA.negate();
+      edgeAB.negate();
+    }
+
+    edgeBC.applyTopLeftRule();
+    edgeCA.applyTopLeftRule();
+    edgeAB.applyTopLeftRule();
+
+    // Set up the plane equations of the interpolated values once per triangle.
+    // The depth is interpolated linearly in screen space. For perspective-
+    // correct varyings, 1/w and the varyings divided by w are interpolated
+    // instead, and the varyings are recovered at every fragment with a single
+    // division.
+
+    const auto toPixel = [](std::int64_t subpixel) {
+      return static_cast<double>(subpixel) / (1 << subpixelBits);
+    };
+
+    auto planeEdgeBC =
+        EdgeFunction(toPixel(xB), toPixel(yB), toPixel(xC), toPixel(yC));
+    auto planeEdgeCA =
+        EdgeFunction(toPixel(xC), toPixel(yC), toPixel(xA), toPixel(yA));
+    auto planeEdgeAB =
+        EdgeFunction(toPixel(xA), toPixel(yA), toPixel(xB), toPixel(yB));
+    const auto planeArea = planeEdgeAB(toPixel(xC), toPixel(yC));
+
+    const auto planeAt = [&](double valueA, double valueB, double valueC) {
+      return PlaneEquation(planeEdgeBC, planeEdgeCA, planeEdgeAB, planeArea,
+                           valueA, valueB, valueC);
+    };
+
+    const auto invWA = screenSpaceVertexA.w;
+    const auto invWB = screenSpaceVertexB.w;
+    const auto invWC = screenSpaceVertexC.w;
+
+    return RasterTriangle{
+        drawCall.index,
+        {edgeBC, edgeCA, edgeAB},
+        {
+            planeAt(screenSpaceVertexA.z, screenSpaceVertexB.z,
+                    screenSpaceVertexC.z),
+            planeAt(invWA, invWB, invWC),
+            planeAt(localVertexA.x * invWA, localVertexB.x * invWB,
+                    localVertexC.x * invWC),
+            planeAt(localVertexA.y * invWA, localVertexB.y * invWB,
+                    localVertexC.y * invWC),
+            planeAt(localVertexA.z * invWA, localVertexB.z * invWB,
+                    localVertexC.z * invWC),
+            planeAt(vertexANormal.x * invWA, vertexBNormal.x * invWB,
+                    vertexCNormal.x * invWC),
+            planeAt(vertexANormal.y * invWA, vertexBNormal.y * invWB,
+                    vertexCNormal.y * invWC),
+            planeAt(vertexANormal.z * invWA, vertexBNormal.z * invWB,
+                    vertexCNormal.z * invWC),
+        },
+        minX,
+        maxX,
+        minY,
+        maxY,
+        std::min({screenSpaceVertexA.z, screenSpaceVertexB.z,
+                  screenSpaceVertexC.z}),
+        std::max({screenSpaceVertexA.z, screenSpaceVertexB.z,
+                  screenSpaceVertexC.z})};
+  }
+
+  /**
+   * Rasterizes the part of a triangle inside the specified rectangle of pixels
+   * and shades the covered fragments.
+   *
+   * @returns The number of fragments shaded.
+   */
+  template <class BufferType>
+  int rasterizeTriangle(RasterTriangle &triangle, int minX, int maxX,
+                         int minY, int maxY, Frame &frame,
+                         RenderTarget<BufferType> &renderTarget,
+                         RenderTarget<double> &depthTexture,
+                         HierarchicalDepthBuffer &hierarchicalDepth) {
+    return std::visit(
+        [&](auto *material) {
+          return rasterizeTriangle(*material, triangle, minX, maxX, minY, maxY,
+                                   frame, renderTarget, depthTexture,
+                                   hierarchicalDepth);
+        },
+        frame.drawCalls[triangle.drawCall].material);
+  }
+
+  /**
+   * Rasterizes a triangle like the overload above, with the material of its
+   * draw call as its concrete type, so that the loops over the pixels are
+   * instantiated for every built-in material and call its shaders directly.
+   */
+  template <class MaterialType, class BufferType>
+  int rasterizeTriangle(MaterialType &material, RasterTriangle &triangle,
+                        int minX, int maxX, int minY, int maxY, Frame &frame,
+                        RenderTarget<BufferType> &renderTarget,
+                        RenderTarget<double> &depthTexture,
+                        HierarchicalDepthBuffer &hierarchicalDepth) {
+    auto &drawCall = frame.drawCalls[triangle.drawCall];
+
+    // Fragments that fail the depth test can only be skipped with early depth
+    // testing. Skip the triangle if it is hidden in every block of the
+    // hierarchical depth buffer that it overlaps, after tightening their depth
+    // ranges.
+
+    const auto &blockSize = HierarchicalDepthBuffer::blockSize;
+    const bool rejectHidden = material.earlyDepthTest;
+
+    if (rejectHidden) {
+      bool visible = false;
+
+      for (int blockY = minY / blockSize; !visible && blockY <= maxY / blockSize;
+           blockY++) {
+        for (int blockX = minX / blockSize;
+             !visible && blockX <= maxX / blockSize; blockX++) {
+          hierarchicalDepth.refresh(blockX, blockY);
+
+          visible = !hierarchicalDepth.isHidden(
+              blockX * blockSize, blockY * blockSize,
+              triangle.minDepth - depthTolerance,
+              triangle.maxDepth + depthTolerance, material.depthTest);
+        }
+      }
+
+      if (!visible) {
+        return 0;
+      }
+    }
+
+    const auto uniforms = drawCall.uniforms(frame);
+    const auto &instanceColor = drawCall.color;
+    const auto &[edgeBC, edgeCA, edgeAB] = triangle.edges;
+    const auto &planes = triangle.planes;
+
+    std::array<double, interpolantCount> values;
+    FragmentBatch fragments;
+    int shadedFragmentCount = 0;
+
+    for (int y = minY; y <= maxY; y++) {
+      // Narrow the row down to the pixels between the triangle's edges, so
+      // that the work is bounded by the area of the triangle rather than that
+      // of its bounding box. The bounds are widened by a pixel to stay
+      // conservative; the edge functions still decide the coverage.
+
+      double rowMinX = minX;
+      double rowMaxX = maxX;
+
+      for (const auto &edge : triangle.edges) {
+        const auto crossing = -static_cast<double>(edge(0, y)) / edge.stepX();
+
+        if (edge.a > 0) {
+          rowMinX = std::max(rowMinX, std::floor(crossing) - 1);
+        } else if (edge.a < 0) {
+          rowMaxX = std::min(rowMaxX, std::ceil(crossing) + 1);
+        }
+      }
+
+      const auto rowStart = static_cast<int>(rowMinX);
+      const auto rowEnd = static_cast<int>(rowMaxX);
+      const auto depthRow =
+          depthTexture.texture.image.data() + y * depthTexture.width;
+
+      for (int spanStart = rowStart - rowStart % spanWidth; spanStart <= rowEnd;
+           spanStart += spanWidth) {
+        const auto spanEnd = std::min(rowEnd, spanStart + spanWidth - 1);
+
+        const SpanSetup span{
+            {edgeBC(spanStart, y), edgeCA(spanStart, y), edgeAB(spanStart, y)},
+            {edgeBC.stepX(), edgeCA.stepX(), edgeAB.stepX()},
+            planes[0](spanStart, y),
+            planes[0].a,
+            std::max(rowStart - spanStart, 0),
+            spanEnd - spanStart,
+            material.depthTest,
+            material.depthWrite};
+
+        // The depths of the span's pixels are computed the same way as in the
+        // span kernel, and the depths of its first and last pixels bound them
+
+        const auto firstDepth = span.depth + span.firstPixel * span.depthStep;
+        const auto lastDepth = span.depth + span.lastPixel * span.depthStep;
+        const auto minDepth = std::min(firstDepth, lastDepth);
+        const auto maxDepth = std::max(firstDepth, lastDepth);
+
+        if (rejectHidden &&
+            hierarchicalDepth.isHidden(spanStart, y, minDepth, maxDepth,
+                                       material.depthTest)) {
+          continue;
+        }
+
+        const auto coverage = frame.spanKernel(span, depthRow + spanStart);
+        const auto &lights = frame.lightsAt(spanStart, y);
+
+        if (coverage.depthPassed != 0 && material.depthWrite) {
+          hierarchicalDepth.expand(spanStart, y, minDepth, maxDepth);
+        }
+
+        // With early depth testing, fragments that fail the depth test are
+        // discarded before running the fragment shader
+
+        const auto shadedPixels =
+            material.earlyDepthTest ? coverage.depthPassed : coverage.covered;
+
+        if (shadedPixels == 0) {
+          continue;
+        }
+
+        for (int i = 0; i < interpolantCount; i++) {
+          values[i] = planes[i](spanStart, y);
+        }
+
+        // With deferred shading, the visible fragments are only written to
+        // the G-buffer, and shaded once all the meshes are drawn
+
+        if (frame.gBuffer) {
+          for (auto pixels = coverage.depthPassed; pixels != 0;
+               pixels &= pixels - 1) {
+            const auto pixel = std::countr_zero(pixels);
+            const auto [localPosition, localNormal] =
+                interpolateVaryings(values, planes, pixel);
+
+            frame.gBuffer->write(spanStart + pixel, y, triangle.drawCall,
+                                 localPosition, localNormal);
+          }
+
+          continue;
+        }
+
+        // Shade the fragments of the span as one batch
+
+        fragments.size = 0;
+
+        for (auto pixels = shadedPixels; pixels != 0; pixels &= pixels - 1) {
+          const auto [localPosition, localNormal] =
+              interpolateVaryings(values, planes, std::countr_zero(pixels));
+
+          fragments.push(localPosition, localNormal);
+        }
+
+        shadeFragments(material, uniforms, fragments, lights);
+        shadedFragmentCount += fragments.size;
+
+        auto fragment = 0;
+
+        for (auto pixels = shadedPixels; pixels != 0;
+             pixels &= pixels - 1, fragment++) {
+          const auto pixel = std::countr_zero(pixels);
+
+          // The span kernel has already written the depth of the fragments
+          // that passed the depth test
+
+          if (coverage.depthPassed & (1u << pixel)) {
+            auto color = fragments.color(fragment);
+
+            if (instanceColor) {
+              color *= instanceColor.value();
+            }
+
+            renderTarget.write(spanStart + pixel, y, color);
+          }
+        }
+      }
+    }
+
+    return shadedFragmentCount;
+  }
+
+  /**
+   * Interpolates the local position and normal of the pixel at the specified
+   * offset from the first pixel of a span, from the values of the
+   * interpolants at the first pixel, divided by w, and their planes.
+   */
+  static std::pair<Vector3, Vector3>
+  interpolateVaryings(const std::array<double, interpolantCount> &values,
+                      const std::array<PlaneEquation, interpolantCount> &planes,
+                      int pixel) {
+    const double offset = pixel;
+    const double w = 1.0 / (values[1] + offset * planes[1].a);
+
+    return {Vector3((values[2] + offset * planes[2].a) * w,
+                    (values[3] + offset * planes[3].a) * w,
+                    (values[4] + offset * planes[4].a) * w),
+            Vector3((values[5] + offset * planes[5].a) * w,
+                    (values[6] + offset * planes[6].a) * w,
+                    (values[7] + offset * planes[7].a) * w)};
+  }
+
+  /**
+   * Runs the fragment shader of the visible fragment at every pixel of the
+   * G-buffer and writes the colors to the render target. The rows of pixels
+   * are split between {@link #threadCount} threads.
+   *
+   * @returns The number of fragments shaded.
+   */
+  template <class BufferType>
+  int shadeGBuffer(GBuffer &gBuffer, std::pmr::vector<DrawCall> &drawCalls,
+                   Frame &frame, RenderTarget<BufferType> &renderTarget) {
+    std::atomic<int> nextRow = 0;
+    std::atomic<int> shadedFragmentCount = 0;
+
+    const auto worker = [&] {
+      FragmentBatch fragments;
+      int workerShadedFragmentCount = 0;
+
+      for (int y = nextRow++; y < renderTarget.height; y = nextRow++) {
+        for (int groupStart = 0; groupStart < renderTarget.width;
+             groupStart += FragmentBatch::capacity) {
+          const auto groupSize = std::min(FragmentBatch::capacity,
+                                          renderTarget.width - groupStart);
+          const auto groupDrawCalls =
+              gBuffer.drawCalls.data() + groupStart + y * renderTarget.width;
+
+          unsigned int remainingPixels = 0;
+
+          for (int pixel = 0; pixel < groupSize; pixel++) {
+            if (groupDrawCalls[pixel] != -1) {
+              remainingPixels |= 1u << pixel;
+            }
+          }
+
+          // Shade the pixels of the group that belong to the same draw call
+          // as one batch
+
+          while (remainingPixels != 0) {
+            const auto drawCallIndex =
+                groupDrawCalls[std::countr_zero(remainingPixels)];
+            unsigned int batchPixels = 0;
+
+            fragments.size = 0;
+
+            for (auto pixels = remainingPixels; pixels != 0;
+                 pixels &= pixels - 1) {
+              const auto pixel = std::countr_zero(pixels);
+
+              if (groupDrawCalls[pixel] == drawCallIndex) {
+                batchPixels |= 1u << pixel;
+                fragments.push(
+                    gBuffer.localPositions.read(groupStart + pixel, y),
+                    gBuffer.localNormals.read(groupStart + pixel, y));
+              }
+            }
+
+            remainingPixels &= ~batchPixels;
+
+            auto &drawCall = drawCalls[drawCallIndex];
+
+            std::visit(
+                [&](auto *material) {
+                  shadeFragments(*material, drawCall.uniforms(frame),
+                                 fragments, frame.lightsAt(groupStart, y));
+                },
+                drawCall.material);
+            workerShadedFragmentCount += fragments.size;
+
+            auto fragment = 0;
+
+            for (auto pixels = batchPixels; pixels != 0;
+                 pixels &= pixels - 1, fragment++) {
+              auto color = fragments.color(fragment);
+
+              if (drawCall.color) {
+                color *= drawCall.color.value();
+              }
+
+              renderTarget.write(groupStart + std::countr_zero(pixels), y,
+                                 color);
+            }
+          }
+        }
+      }
+
+      shadedFragmentCount += workerShadedFragmentCount;
+    };
+
+    workerPool().run(worker);
+
+    return shadedFragmentCount;
+  }
+
+  /**
+   * Renders the triangles in parallel using a sort-middle tiled approach.
+   *
+   * The triangles are first binned into the screen tiles their bounding boxes
+   * overlap. The tiles are then rasterized and shaded independently by {@link
+   * #threadCount} threads. Within a tile, the triangles are drawn in the order
+   * they were submitted, so the output is the same as the single-threaded
+   * renderer's.
+   *
+   * @returns The number of fragments shaded.
+   */
+  template <class BufferType>
+  int renderTiles(std::pmr::vector<RasterTriangle> &triangles, Frame &frame,
+                   RenderTarget<BufferType> &renderTarget,
+                   RenderTarget<double> &depthTexture,
+                   HierarchicalDepthBuffer &hierarchicalDepth) {
+    const auto tilesX = (renderTarget.width + tileSize - 1) / tileSize;
+    const auto tilesY = (renderTarget.height + tileSize - 1) / tileSize;
+
+    // Bin the triangles. A tile is skipped if the pixel centers in it are all
+    // outside any of the triangle's edges.
+
+    std::pmr::vector<std::pmr::vector<int>> bins(tilesX * tilesY,
+                                                 &frameArena);
+
+    for (int i = 0; i < static_cast<int>(triangles.size()); i++) {
+      const auto &triangle = triangles[i];
+
+      for (int tileY = triangle.minY / tileSize;
+           tileY <= triangle.maxY / tileSize; tileY++) {
+        for (int tileX = triangle.minX / tileSize;
+             tileX <= triangle.maxX / tileSize; tileX++) {
+          const auto tileMinX = tileX * tileSize;
+          const auto tileMinY = tileY * tileSize;
+          const auto tileMaxX = tileMinX + tileSize - 1;
+          const auto tileMaxY = tileMinY + tileSize - 1;
+
+          const auto overlaps = std::all_of(
+              triangle.edges.begin(), triangle.edges.end(),
+              [&](const FixedPointEdgeFunction &edge) {
+                return edge(edge.a > 0 ? tileMaxX : tileMinX,
+                            edge.b > 0 ? tileMaxY : tileMinY) >= 0;
+              });
+
+          if (overlaps) {
+            bins[tileX + tileY * tilesX].push_back(i);
+          }
+        }
+      }
+    }
+
+    // Rasterize and shade the tiles in parallel
+
+    std::atomic<int> nextTile = 0;
+    std::atomic<int> shadedFragmentCount = 0;
+
+    const auto worker = [&] {
+      int workerShadedFragmentCount = 0;
+
+      for (int tile = nextTile++; tile < tilesX * tilesY; tile = nextTile++) {
+        const auto tileMinX = (tile % tilesX) * tileSize;
+        const auto tileMinY = (tile / tilesX) * tileSize;
+        const auto tileMaxX =
+            std::min(tileMinX + tileSize, renderTarget.width) - 1;
+        const auto tileMaxY =
+            std::min(tileMinY + tileSize, renderTarget.height) - 1;
+
+        for (int i : bins[tile]) {
+          auto &triangle = triangles[i];
+
+          workerShadedFragmentCount += rasterizeTriangle(
+              triangle, std::max(triangle.minX, tileMinX),
+              std::min(triangle.maxX, tileMaxX),
+              std::max(triangle.minY, tileMinY),
+              std::min(triangle.maxY, tileMaxY), frame, renderTarget,
+              depthTexture, hierarchicalDepth);
+        }
+      }
+
+      shadedFragmentCount += workerShadedFragmentCount;
+    };
+
+    workerPool().run(worker);
+
+    return shadedFragmentCount;
+  }
+
+  /**
+   * The storage that is reused from frame to frame, so that once it has grown
+   * to fit the scene and the render target, rendering does not allocate any
+   * memory. The scratch buffers whose sizes vary from frame to frame are
+   * allocated from {@link #frameArena} instead.
+   */
+  struct RenderContext {
+    std::vector<std::reference_wrapper<Mesh>> meshes;
+    std::vector<std::reference_wrapper<Light>> lights;
+    LightList frameLights; // The lights of the frame, resolved
+    std::stack<std::reference_wrapper<Object3D>,
+               std::vector<std::reference_wrapper<Object3D>>>
+        objects; // The scene graph traversal
+
+    // The buffers sized after the render target
+
+    std::optional<RenderTarget<double>> depthTexture;
+    std::optional<HierarchicalDepthBuffer> hierarchicalDepth;
+    std::optional<OcclusionBuffer> occlusionBuffer;
+    std::optional<GBuffer> gBuffer;
+    std::optional<LightGrid> lightGrid;
+
+    std::unique_ptr<WorkerPool> workerPool;
+  };
+
+  RenderContext context;
+
+  /**
+   * Returns the pool of {@link #threadCount} threads, which is only recreated
+   * when the number of threads changes.
+   */
+  WorkerPool &workerPool() {
+    if (!context.workerPool ||
+        context.workerPool->threadCount != threadCount) {
+      context.workerPool = std::make_unique<WorkerPool>(threadCount);
+    }
+
+    return *context.workerPool;
+  }
 };
 
 } // namespace t
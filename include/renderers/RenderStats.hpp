@@ -0,0 +1,37 @@
+#include <cstddef>
+
+#ifndef RENDERSTATS_HPP
+#define RENDERSTATS_HPP
+
+namespace t {
+
+/**
+ * Statistics about a single render, useful for measuring the amount of work
+ * done by the renderer.
+ *
+ * @see Rasterizer#stats
+ *
+ * \ingroup renderers
+ */
+struct RenderStats {
+  int drawCalls = 0; /**< The number of draw calls i.e. meshes drawn. */
+  int culledMeshes = 0; /**< The number of meshes skipped by frustum
+                           culling. */
+  int occludedMeshes = 0; /**< The number of meshes skipped by occlusion
+                             culling. */
+  int vertexShaderInvocations =
+      0;             /**< The number of times a vertex shader was run. */
+  int triangles = 0; /**< The number of triangles assembled from the meshes'
+                        geometries. */
+  int rasterizedTriangles = 0; /**< The number of triangles that were
+                                  rasterized after clipping and culling. */
+  int fragmentShaderInvocations =
+      0; /**< The number of times a fragment shader was run. */
+  std::size_t scratchMemory =
+      0; /**< The number of bytes of scratch memory allocated from {@link
+            Rasterizer#frameArena}. */
+};
+
+} // namespace t
+
+#endif // RENDERSTATS_HPP
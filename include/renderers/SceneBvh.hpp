@@ -0,0 +1,286 @@
+#include "lights/Light.hpp"
+#include "math/BoundingBox.hpp"
+#include "primitives/Mesh.hpp"
+#include "primitives/Scene.hpp"
+#include <algorithm>
+#include <functional>
+#include <stack>
+#include <unordered_map>
+#include <vector>
+
+#ifndef SCENEBVH_HPP
+#define SCENEBVH_HPP
+
+namespace t {
+
+/**
+ * A bounding volume hierarchy (BVH) over the world-space bounding boxes of the
+ * meshes of a scene.
+ *
+ * Rendering a scene through its BVH (see {@link Rasterizer#render}) skips the
+ * traversal of the scene graph: the meshes outside the view frustum or hidden
+ * behind occluders are rejected a whole subtree at a time, so that the cost of
+ * culling grows with the number of visible meshes rather than the size of the
+ * scene.
+ *
+ * The BVH owns the transformations of the scene. Its matrices and bounding
+ * boxes are only updated by {@link #update} for the objects that moved, and by
+ * {@link #rebuild} for the whole scene, which is required after objects are
+ * added or removed, or after the geometry of a mesh changes.
+ *
+ * \ingroup renderers
+ */
+class SceneBvh {
+public:
+  /**
+   * The maximum number of meshes in a leaf of the hierarchy.
+   */
+  static constexpr int leafSize = 4;
+
+  Scene &scene; /**< The scene of this BVH. */
+  std::vector<std::reference_wrapper<Light>>
+      lights; /**< The lights of the scene. */
+
+  /**
+   * Creates a new BVH over the meshes of the specified scene.
+   *
+   * @param _scene The scene.
+   */
+  explicit SceneBvh(Scene &_scene) : scene(_scene) { rebuild(); }
+
+  /**
+   * Returns the number of meshes in this BVH.
+   */
+  int meshCount() const { return static_cast<int>(items.size()); }
+
+  /**
+   * Updates the matrices of every object of the scene, then builds the
+   * hierarchy from scratch.
+   */
+  void rebuild() {
+    items.clear();
+    nodes.clear();
+    itemIndices.clear();
+    lights.clear();
+
+    updateMatrices(scene, [&](Object3D &object) {
+      if (object.isMesh()) {
+        auto &mesh = static_cast<Mesh &>(object);
+
+        items.push_back({mesh, worldBoundingBox(mesh), 0});
+      } else if (object.isLight()) {
+        lights.push_back(static_cast<Light &>(object));
+      }
+    });
+
+    if (items.empty()) {
+      return;
+    }
+
+    nodes.reserve(2 * items.size());
+    nodes.push_back({BoundingBox(), -1, -1, 0, meshCount()});
+    build(0);
+
+    for (int i = 0; i < meshCount(); i++) {
+      itemIndices[&items[i].mesh.get()] = i;
+    }
+  }
+
+  /**
+   * Updates the matrices of an object that moved and of its descendants, then
+   * refits the bounding boxes of the hierarchy above the meshes among them.
+   *
+   * The hierarchy is not rebuilt, so it may become less efficient, but not
+   * incorrect, as objects move far from where they were.
+   *
+   * @param object An object of the scene that was added before the last
+   * {@link #rebuild}.
+   */
+  void update(Object3D &object) {
+    updateMatrices(object, [&](Object3D &updatedObject) {
+      if (!updatedObject.isMesh()) {
+        return;
+      }
+
+      auto &mesh = static_cast<Mesh &>(updatedObject);
+      auto &item = items[itemIndices.at(&mesh)];
+
+      item.boundingBox = worldBoundingBox(mesh);
+      refit(item.node);
+    });
+  }
+
+  /**
+   * Visits the meshes of the subtrees that are accepted by a test.
+   *
+   * @param test A function called with the world-space bounding box of a
+   * subtree, which returns whether to visit the subtree.
+   * @param visit A function called with every visited mesh.
+   */
+  template <class Test, class Visit> void traverse(Test test, Visit visit) {
+    if (nodes.empty()) {
+      return;
+    }
+
+    auto &stack = nodeStack;
+    stack.push(0);
+
+    while (!stack.empty()) {
+      const auto &node = nodes[stack.top()];
+      stack.pop();
+
+      if (!test(node.boundingBox)) {
+        continue;
+      }
+
+      if (node.left == -1) {
+        for (int i = node.firstMesh; i < node.firstMesh + node.meshCount; i++) {
+          visit(items[i].mesh.get());
+        }
+      } else {
+        stack.push(node.left + 1);
+        stack.push(node.left);
+      }
+    }
+  }
+
+private:
+  struct Item {
+    std::reference_wrapper<Mesh> mesh;
+    BoundingBox boundingBox; // In world space
+    int node;                // The leaf containing the mesh
+  };
+
+  struct Node {
+    BoundingBox boundingBox;
+    int parent;
+    int left; // The index of the first child, followed by the second; -1 for
+              // leaves
+    int firstMesh;
+    int meshCount;
+  };
+
+  std::vector<Item> items;
+  std::vector<Node> nodes;
+  std::unordered_map<const Mesh *, int> itemIndices;
+
+  // The stacks of the traversals, kept so that they do not allocate again
+
+  std::stack<int, std::vector<int>> nodeStack;
+  std::stack<std::reference_wrapper<Object3D>,
+             std::vector<std::reference_wrapper<Object3D>>>
+      objectStack;
+
+  /**
+   * Traverses the scene graph from an object like the rasterizer does, to
+   * update the local and model matrices. The function is called with every
+   * updated object.
+   */
+  template <class Function>
+  void updateMatrices(Object3D &root, Function function) {
+    auto &objects = objectStack;
+
+    root.updateLocalMatrix();
+    root.updateModelMatrix();
+    function(root);
+
+    if (root.isMesh()) {
+      return;
+    }
+
+    objects.push(root);
+
+    while (!objects.empty()) {
+      Object3D &parent = objects.top();
+      objects.pop();
+
+      for (Object3D &child : parent.children) {
+        child.updateLocalMatrix();
+        child.updateModelMatrix();
+        function(child);
+
+        if (!child.isMesh()) {
+          objects.push(child);
+        }
+      }
+    }
+  }
+
+  static BoundingBox worldBoundingBox(Mesh &mesh) {
+    return mesh.localBoundingBox().transform(mesh.modelMatrix);
+  }
+
+  /**
+   * Splits a node at the median of the centers of its meshes' bounding boxes
+   * along the longest axis, until the leaves are small enough.
+   */
+  void build(int index) {
+    const auto first = nodes[index].firstMesh;
+    const auto count = nodes[index].meshCount;
+
+    // Meshes with empty geometries are sorted as if they were at the origin
+
+    const auto centerOf = [&](const Item &item) {
+      return item.boundingBox.isEmpty() ? Vector3(0, 0, 0)
+                                        : item.boundingBox.center();
+    };
+
+    auto centers = BoundingBox();
+
+    for (int i = first; i < first + count; i++) {
+      nodes[index].boundingBox.expandByBox(items[i].boundingBox);
+      centers.expandByPoint(centerOf(items[i]));
+      items[i].node = index;
+    }
+
+    if (count <= leafSize) {
+      return;
+    }
+
+    const auto extent = centers.max - centers.min;
+    const auto axis = extent.x >= extent.y && extent.x >= extent.z ? 0
+                      : extent.y >= extent.z                     ? 1
+                                                                 : 2;
+    const auto middle = first + count / 2;
+
+    std::nth_element(items.begin() + first, items.begin() + middle,
+                     items.begin() + first + count,
+                     [&](const Item &a, const Item &b) {
+                       return centerOf(a)[axis] < centerOf(b)[axis];
+                     });
+
+    const auto left = static_cast<int>(nodes.size());
+
+    nodes[index].left = left;
+    nodes.push_back({BoundingBox(), index, -1, first, middle - first});
+    nodes.push_back({BoundingBox(), index, -1, middle, first + count - middle});
+
+    build(left);
+    build(left + 1);
+  }
+
+  /**
+   * Recomputes the bounding box of a leaf, then of its ancestors.
+   */
+  void refit(int index) {
+    auto &leaf = nodes[index];
+
+    leaf.boundingBox = BoundingBox();
+
+    for (int i = leaf.firstMesh; i < leaf.firstMesh + leaf.meshCount; i++) {
+      leaf.boundingBox.expandByBox(items[i].boundingBox);
+    }
+
+    for (auto parent = leaf.parent; parent != -1;
+         parent = nodes[parent].parent) {
+      auto &node = nodes[parent];
+
+      node.boundingBox = nodes[node.left].boundingBox;
+      node.boundingBox.expandByBox(nodes[node.left + 1].boundingBox);
+    }
+  }
+};
+
+} // namespace t
+
+#endif // SCENEBVH_HPP
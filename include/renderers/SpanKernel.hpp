@@ -0,0 +1,374 @@
+#include <array>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) ||            \
+    defined(_M_IX86)
+#define T_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+/**
+ * \file SpanKernel.hpp
+ * Contains the kernels that test the coverage and depth of a span of pixels,
+ * with scalar, SSE4.1, and AVX2 implementations selected at runtime.
+ */
+
+#ifndef SPANKERNEL_HPP
+#define SPANKERNEL_HPP
+
+// GCC and Clang only emit instructions of an extension in functions that
+// target it; MSVC emits any intrinsic it is given.
+
+#if defined(__GNUC__) || defined(__clang__)
+#define T_TARGET(extension) __attribute__((target(extension)))
+#else
+#define T_TARGET(extension)
+#endif
+
+namespace t {
+
+/**
+ * The number of pixels in a span. Rows of pixels are processed in spans
+ * aligned to this width.
+ */
+constexpr int spanWidth = 8;
+
+/**
+ * The instruction sets that the span kernels are implemented with, from the
+ * least to the most capable.
+ */
+enum class InstructionSet {
+  Scalar, /**< Plain C++, available on any processor. */
+  Sse41,  /**< SSE4.1; two pixels per instruction. */
+  Avx2,   /**< AVX2; four pixels per instruction. */
+};
+
+/**
+ * The inputs of a span kernel.
+ */
+struct SpanSetup {
+  std::array<std::int64_t, 3>
+      weights; /**< The values of the triangle's fixed-point edge functions at
+                  the first pixel of the span. A pixel is covered if all of
+                  them are non-negative. */
+  std::array<std::int64_t, 3>
+      weightSteps; /**< The increments of the edge functions' values from one
+                      pixel to the next. */
+  double depth;      /**< The depth at the first pixel of the span. */
+  double depthStep;  /**< The increment of the depth from one pixel to the
+                        next. */
+  int firstPixel;    /**< The index of the first pixel to test in the span. */
+  int lastPixel;     /**< The index of the last pixel to test in the span. */
+  bool depthTest;    /**< Same as {@link Material#depthTest}. */
+  bool depthWrite;   /**< Same as {@link Material#depthWrite}. */
+};
+
+/**
+ * The outputs of a span kernel, as bit masks where bit `i` is the `i`-th pixel
+ * of the span.
+ */
+struct SpanCoverage {
+  unsigned covered = 0;     /**< The pixels covered by the triangle. */
+  unsigned depthPassed = 0; /**< The covered pixels that pass the depth
+                               test. */
+};
+
+/**
+ * A function that tests the coverage and depth of the pixels of a span, and
+ * writes the depth of the pixels that pass the depth test if
+ * {@link SpanSetup#depthWrite} is set.
+ *
+ * The depth buffer points at the depth of the first pixel of the span; only
+ * the pixels from {@link SpanSetup#firstPixel} to {@link SpanSetup#lastPixel}
+ * are read or written.
+ *
+ * The coverage is computed with exact integer arithmetic, and all
+ * implementations compute the depth of pixel `i` as `depth + i * depthStep`
+ * with the same operations, so their results are bit-identical.
+ */
+using SpanKernel = SpanCoverage (*)(const SpanSetup &span, double *depthBuffer);
+
+/**
+ * Tests the coverage and depth of a span one pixel at a time.
+ */
+inline SpanCoverage scalarSpanKernel(const SpanSetup &span,
+                                     double *depthBuffer) {
+  SpanCoverage coverage;
+
+  for (int i = span.firstPixel; i <= span.lastPixel; i++) {
+    if (span.weights[0] + i * span.weightSteps[0] >= 0 &&
+        span.weights[1] + i * span.weightSteps[1] >= 0 &&
+        span.weights[2] + i * span.weightSteps[2] >= 0) {
+      coverage.covered |= 1u << i;
+
+      const double offset = i;
+      const double z = span.depth + offset * span.depthStep;
+
+      if ((z <= depthBuffer[i]) == span.depthTest) {
+        coverage.depthPassed |= 1u << i;
+
+        if (span.depthWrite) {
+          depthBuffer[i] = z;
+        }
+      }
+    }
+  }
+
+  return coverage;
+}
+
+#ifdef T_X86
+
+/**
+ * Copies the depths of the pixels to test of a partial span into `buffer`,
+ * so that the kernels can load and store whole vectors.
+ *
+ * @returns The buffer that the kernels should read and write.
+ */
+inline double *spanDepthBuffer(const SpanSetup &span, double *depthBuffer,
+                               double *buffer) {
+  if (span.firstPixel == 0 && span.lastPixel == spanWidth - 1) {
+    return depthBuffer;
+  }
+
+  for (int i = span.firstPixel; i <= span.lastPixel; i++) {
+    buffer[i] = depthBuffer[i];
+  }
+
+  return buffer;
+}
+
+/**
+ * Copies the depths of a partial span back from the buffer returned by
+ * {@link #spanDepthBuffer}.
+ */
+inline void storeSpanDepthBuffer(const SpanSetup &span, double *depthBuffer,
+                                 const double *buffer) {
+  if (buffer == depthBuffer) {
+    return;
+  }
+
+  for (int i = span.firstPixel; i <= span.lastPixel; i++) {
+    depthBuffer[i] = buffer[i];
+  }
+}
+
+/**
+ * Tests the coverage and depth of a span two pixels at a time with SSE4.1.
+ *
+ * A pixel is outside an edge if the sign bit of its weight is set, so the
+ * weights of the three edges are OR-ed together and their sign bits are used
+ * as masks directly.
+ */
+T_TARGET("sse4.1")
+inline SpanCoverage sse41SpanKernel(const SpanSetup &span,
+                                    double *depthBuffer) {
+  alignas(16) double buffer[spanWidth] = {};
+  double *depths = spanDepthBuffer(span, depthBuffer, buffer);
+
+  const __m128d allOnes = _mm_castsi128_pd(_mm_set1_epi64x(-1));
+  const __m128d firstPixel = _mm_set1_pd(span.firstPixel);
+  const __m128d lastPixel = _mm_set1_pd(span.lastPixel);
+  const __m128d depthTestMask = span.depthTest ? _mm_setzero_pd() : allOnes;
+
+  __m128i weights[3];
+  __m128i weightSteps[3];
+
+  for (int edge = 0; edge < 3; edge++) {
+    weights[edge] =
+        _mm_set_epi64x(span.weights[edge] + span.weightSteps[edge],
+                       span.weights[edge]);
+    weightSteps[edge] = _mm_set1_epi64x(span.weightSteps[edge] * 2);
+  }
+
+  SpanCoverage coverage;
+
+  for (int i = 0; i < spanWidth; i += 2) {
+    const __m128d offset = _mm_set_pd(i + 1, i);
+
+    const __m128d outside = _mm_or_pd(
+        _mm_or_pd(_mm_cmplt_pd(offset, firstPixel),
+                  _mm_cmpgt_pd(offset, lastPixel)),
+        _mm_castsi128_pd(_mm_or_si128(
+            _mm_or_si128(weights[0], weights[1]), weights[2])));
+
+    for (int edge = 0; edge < 3; edge++) {
+      weights[edge] = _mm_add_epi64(weights[edge], weightSteps[edge]);
+    }
+
+    const auto coveredMask =
+        ~static_cast<unsigned>(_mm_movemask_pd(outside)) & 0x3u;
+
+    if (coveredMask == 0) {
+      continue;
+    }
+
+    const __m128d z = _mm_add_pd(
+        _mm_set1_pd(span.depth),
+        _mm_mul_pd(offset, _mm_set1_pd(span.depthStep)));
+    const __m128d currentDepth = _mm_loadu_pd(depths + i);
+    const __m128d rejected = _mm_or_pd(
+        outside, _mm_xor_pd(_mm_xor_pd(_mm_cmple_pd(z, currentDepth),
+                                       depthTestMask),
+                            allOnes));
+
+    coverage.covered |= coveredMask << i;
+    coverage.depthPassed |=
+        (~static_cast<unsigned>(_mm_movemask_pd(rejected)) & 0x3u) << i;
+
+    if (span.depthWrite) {
+      _mm_storeu_pd(depths + i, _mm_blendv_pd(z, currentDepth, rejected));
+    }
+  }
+
+  storeSpanDepthBuffer(span, depthBuffer, depths);
+
+  return coverage;
+}
+
+/**
+ * Tests the coverage and depth of a span four pixels at a time with AVX2, the
+ * same way as {@link #sse41SpanKernel}.
+ */
+T_TARGET("avx2")
+inline SpanCoverage avx2SpanKernel(const SpanSetup &span, double *depthBuffer) {
+  alignas(32) double buffer[spanWidth] = {};
+  double *depths = spanDepthBuffer(span, depthBuffer, buffer);
+
+  const __m256d allOnes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+  const __m256d firstPixel = _mm256_set1_pd(span.firstPixel);
+  const __m256d lastPixel = _mm256_set1_pd(span.lastPixel);
+  const __m256d depthTestMask =
+      span.depthTest ? _mm256_setzero_pd() : allOnes;
+
+  __m256i weights[3];
+  __m256i weightSteps[3];
+
+  for (int edge = 0; edge < 3; edge++) {
+    const auto weight = span.weights[edge];
+    const auto step = span.weightSteps[edge];
+
+    weights[edge] = _mm256_set_epi64x(weight + step * 3, weight + step * 2,
+                                      weight + step, weight);
+    weightSteps[edge] = _mm256_set1_epi64x(step * 4);
+  }
+
+  SpanCoverage coverage;
+
+  for (int i = 0; i < spanWidth; i += 4) {
+    const __m256d offset = _mm256_set_pd(i + 3, i + 2, i + 1, i);
+
+    const __m256d outside = _mm256_or_pd(
+        _mm256_or_pd(_mm256_cmp_pd(offset, firstPixel, _CMP_LT_OQ),
+                     _mm256_cmp_pd(offset, lastPixel, _CMP_GT_OQ)),
+        _mm256_castsi256_pd(_mm256_or_si256(
+            _mm256_or_si256(weights[0], weights[1]), weights[2])));
+
+    for (int edge = 0; edge < 3; edge++) {
+      weights[edge] = _mm256_add_epi64(weights[edge], weightSteps[edge]);
+    }
+
+    const auto coveredMask =
+        ~static_cast<unsigned>(_mm256_movemask_pd(outside)) & 0xFu;
+
+    if (coveredMask == 0) {
+      continue;
+    }
+
+    const __m256d z = _mm256_add_pd(
+        _mm256_set1_pd(span.depth),
+        _mm256_mul_pd(offset, _mm256_set1_pd(span.depthStep)));
+    const __m256d currentDepth = _mm256_loadu_pd(depths + i);
+    const __m256d rejected = _mm256_or_pd(
+        outside,
+        _mm256_xor_pd(_mm256_xor_pd(_mm256_cmp_pd(z, currentDepth, _CMP_LE_OQ),
+                                    depthTestMask),
+                      allOnes));
+
+    coverage.covered |= coveredMask << i;
+    coverage.depthPassed |=
+        (~static_cast<unsigned>(_mm256_movemask_pd(rejected)) & 0xFu) << i;
+
+    if (span.depthWrite) {
+      _mm256_storeu_pd(depths + i, _mm256_blendv_pd(z, currentDepth, rejected));
+    }
+  }
+
+  storeSpanDepthBuffer(span, depthBuffer, depths);
+
+  return coverage;
+}
+
+#endif // T_X86
+
+/**
+ * Returns the most capable instruction set supported by the processor and the
+ * operating system.
+ */
+inline InstructionSet supportedInstructionSet() {
+  static const InstructionSet instructionSet = [] {
+#if defined(T_X86) && defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid(info, 1);
+    const bool sse41 = info[2] & (1 << 19);
+    const bool osxsave = info[2] & (1 << 27);
+    const bool avx = info[2] & (1 << 28);
+
+    // AVX registers are only usable if the operating system saves them
+
+    bool avx2 = false;
+
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 6) == 6) {
+      __cpuidex(info, 7, 0);
+      avx2 = info[1] & (1 << 5);
+    }
+
+    return avx2    ? InstructionSet::Avx2
+           : sse41 ? InstructionSet::Sse41
+                   : InstructionSet::Scalar;
+#elif defined(T_X86)
+    __builtin_cpu_init();
+
+    return __builtin_cpu_supports("avx2")     ? InstructionSet::Avx2
+           : __builtin_cpu_supports("sse4.1") ? InstructionSet::Sse41
+                                              : InstructionSet::Scalar;
+#else
+    return InstructionSet::Scalar;
+#endif
+  }();
+
+  return instructionSet;
+}
+
+/**
+ * Returns the span kernel implemented with the given instruction set, or with
+ * the most capable supported one if the given instruction set is not
+ * supported.
+ */
+inline SpanKernel selectSpanKernel(InstructionSet instructionSet) {
+  if (instructionSet > supportedInstructionSet()) {
+    instructionSet = supportedInstructionSet();
+  }
+
+  switch (instructionSet) {
+#ifdef T_X86
+  case InstructionSet::Avx2:
+    return avx2SpanKernel;
+  case InstructionSet::Sse41:
+    return sse41SpanKernel;
+#endif
+  default:
+    return scalarSpanKernel;
+  }
+}
+
+} // namespace t
+
+#endif // SPANKERNEL_HPP
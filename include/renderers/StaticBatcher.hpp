@@ -0,0 +1,257 @@
+#include "geometries/Geometry.hpp"
+#include "materials/Material.hpp"
+#include "math/Matrix3x3.hpp"
+#include "math/Matrix4x4.hpp"
+#include "math/Vector3.hpp"
+#include "math/Vector4.hpp"
+#include "primitives/BufferAttribute.hpp"
+#include "primitives/Mesh.hpp"
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#ifndef STATICBATCHER_HPP
+#define STATICBATCHER_HPP
+
+namespace t {
+
+/**
+ * Merges the static meshes that share a material into combined meshes, so
+ * that they are drawn with a single draw call.
+ *
+ * The static meshes (see {@link Mesh#isStatic}) with the same material, front
+ * face, and {@link Mesh#occluder} flag are pre-transformed to world space and
+ * concatenated into one {@link Geometry}. Meshes with levels of detail are
+ * not batched, so that their levels are still selected. The batches are
+ * cached: they are only rebuilt when the static meshes, their order, their
+ * model matrices, front faces, or occluder flags change, which {@link #apply}
+ * checks every frame. Changes to the geometries of static meshes are not
+ * detected; call {@link #invalidate} after them.
+ *
+ * Since the combined geometries are in world space, the shaders see them with
+ * identity model and normal matrices. The meshes whose materials depend on the
+ * local space, such as {@link NormalColor}, are therefore not batched (see
+ * {@link Material#batchable}).
+ *
+ * \ingroup renderers
+ */
+class StaticBatcher {
+public:
+  /**
+   * Returns the number of batches, each merging at least 2 meshes.
+   *
+   * @returns The number of batches.
+   */
+  int batchCount() const { return static_cast<int>(batches.size()); }
+
+  /**
+   * Discards the batches, so that they are rebuilt on the next call to
+   * {@link #apply}.
+   */
+  void invalidate() {
+    batches.clear();
+    batchIndices.clear();
+    snapshot.clear();
+  }
+
+  /**
+   * Replaces the static meshes of a list of meshes with their batches. A
+   * batch takes the place of the first of its meshes in the list; the meshes
+   * that are not batched keep their order.
+   *
+   * @param meshes The meshes to draw, whose model matrices are up to date.
+   */
+  void apply(std::vector<std::reference_wrapper<Mesh>> &meshes) {
+    staticMeshes.clear();
+
+    for (Mesh &mesh : meshes) {
+      if (mesh.isStatic && !mesh.isInstancedMesh() &&
+          mesh.levelsOfDetail.empty() && mesh.material.batchable) {
+        staticMeshes.push_back(mesh);
+      }
+    }
+
+    if (!isUpToDate()) {
+      rebuild();
+    }
+
+    if (batches.empty()) {
+      return;
+    }
+
+    for (auto &batch : batches) {
+      batch.drawn = false;
+    }
+
+    auto last = meshes.begin();
+
+    for (Mesh &mesh : meshes) {
+      const auto batchIndex = batchIndices.find(&mesh);
+
+      if (batchIndex == batchIndices.end()) {
+        *last++ = mesh;
+      } else if (auto &batch = batches[batchIndex->second]; !batch.drawn) {
+        batch.drawn = true;
+        *last++ = batch.mesh;
+      }
+    }
+
+    meshes.erase(last, meshes.end());
+  }
+
+private:
+  struct Batch {
+    Geometry geometry; // In world space
+    Mesh mesh;
+    bool drawn = false; // Whether the batch is already in the list of meshes
+
+    Batch(Material &material, FrontFace frontFace, bool occluder)
+        : geometry(BufferAttribute<double>({}, 3),
+                   BufferAttribute<double>({}, 3)),
+          mesh(geometry, material) {
+      geometry.frontFace = frontFace;
+      geometry.setIndices(BufferAttribute<int>({}, 3));
+      mesh.occluder = occluder;
+    }
+  };
+
+  // What the batch of a static mesh depends on
+
+  struct SnapshotEntry {
+    const Mesh *mesh;
+    Matrix4x4 modelMatrix;
+    FrontFace frontFace;
+    bool occluder;
+  };
+
+  std::deque<Batch> batches;
+  std::unordered_map<const Mesh *, int> batchIndices;
+  std::vector<SnapshotEntry> snapshot; // The static meshes of the batches
+  std::vector<std::reference_wrapper<Mesh>> staticMeshes;
+
+  /**
+   * Checks whether the batches were built from the current static meshes.
+   */
+  bool isUpToDate() const {
+    if (snapshot.size() != staticMeshes.size()) {
+      return false;
+    }
+
+    for (std::size_t i = 0; i < snapshot.size(); i++) {
+      const Mesh &mesh = staticMeshes[i];
+
+      if (snapshot[i].mesh != &mesh ||
+          snapshot[i].modelMatrix != mesh.modelMatrix ||
+          snapshot[i].frontFace != mesh.geometry.frontFace ||
+          snapshot[i].occluder != mesh.occluder) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  void rebuild() {
+    invalidate();
+
+    // Group the static meshes by material, front face, and occluder flag,
+    // keeping only the groups of at least 2 meshes
+
+    std::vector<std::vector<std::reference_wrapper<Mesh>>> groups;
+
+    for (Mesh &mesh : staticMeshes) {
+      snapshot.push_back({&mesh, mesh.modelMatrix, mesh.geometry.frontFace,
+                          mesh.occluder});
+
+      const auto group = std::find_if(
+          groups.begin(), groups.end(), [&](const auto &meshesOfGroup) {
+            const Mesh &first = meshesOfGroup.front();
+
+            return &first.material == &mesh.material &&
+                   first.geometry.frontFace == mesh.geometry.frontFace &&
+                   first.occluder == mesh.occluder;
+          });
+
+      if (group == groups.end()) {
+        groups.push_back({mesh});
+      } else {
+        group->push_back(mesh);
+      }
+    }
+
+    for (const auto &group : groups) {
+      if (group.size() < 2) {
+        continue;
+      }
+
+      const Mesh &first = group.front();
+      auto &batch = batches.emplace_back(first.material,
+                                         first.geometry.frontFace,
+                                         first.occluder);
+
+      for (Mesh &mesh : group) {
+        append(batch.geometry, mesh);
+        batchIndices[&mesh] = batchCount() - 1;
+      }
+    }
+  }
+
+  /**
+   * Appends the triangles of a mesh, transformed to world space, to a
+   * combined geometry.
+   */
+  static void append(Geometry &combined, const Mesh &mesh) {
+    const auto &geometry = mesh.geometry;
+    const auto &modelMatrix = mesh.modelMatrix;
+    const auto &normalMatrix = mesh.normalMatrix;
+    const auto vertexCount =
+        static_cast<int>(geometry.vertexPositions.array.size() / 3);
+    const auto firstVertex =
+        static_cast<int>(combined.vertexPositions.array.size() / 3);
+
+    auto &positions = combined.vertexPositions.array;
+    auto &normals = combined.vertexNormals.array;
+    auto &indices = combined.faceIndices.value().array;
+
+    for (int i = 0; i < vertexCount; i++) {
+      const auto position =
+          modelMatrix *
+          Vector4(Vector3::fromBufferAttribute(geometry.vertexPositions, i), 1);
+      const auto normal =
+          normalMatrix *
+          Vector3::fromBufferAttribute(geometry.vertexNormals, i);
+
+      positions.insert(positions.end(), {position.x, position.y, position.z});
+      normals.insert(normals.end(), {normal.x, normal.y, normal.z});
+    }
+
+    // The winding of the triangles is kept: it is only tested after the
+    // projection, which sees the same positions as without batching
+
+    const auto appendTriangle = [&](int a, int b, int c) {
+      indices.insert(indices.end(),
+                     {firstVertex + a, firstVertex + b, firstVertex + c});
+    };
+
+    if (geometry.faceIndices) {
+      const auto &faceIndices = geometry.faceIndices.value().array;
+
+      for (std::size_t i = 0; i < faceIndices.size(); i += 3) {
+        appendTriangle(faceIndices[i], faceIndices[i + 1], faceIndices[i + 2]);
+      }
+    } else {
+      for (int i = 0; i + 2 < vertexCount; i += 3) {
+        appendTriangle(i, i + 1, i + 2);
+      }
+    }
+
+    combined.boundingBox.reset();
+    combined.boundingSphere.reset();
+  }
+};
+
+} // namespace t
+
+#endif // STATICBATCHER_HPP
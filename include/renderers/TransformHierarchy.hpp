@@ -0,0 +1,251 @@
+#include "lights/Light.hpp"
+#include "math/Matrix4x4.hpp"
+#include "primitives/Mesh.hpp"
+#include "primitives/Object3D.hpp"
+#include "renderers/WorkerPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <stack>
+#include <vector>
+
+#ifndef TRANSFORMHIERARCHY_HPP
+#define TRANSFORMHIERARCHY_HPP
+
+namespace t {
+
+/**
+ * A flattened copy of the hierarchy of a scene graph, through which the model
+ * matrices of its objects are updated in a linear pass.
+ *
+ * The objects are stored level by level, every parent before its children,
+ * in contiguous arrays along with the indices of their parents, their model
+ * matrices, and whether these changed in the last update. Updating walks the
+ * arrays in order, reading the model matrix of the parent from the array
+ * rather than from the parent object. The objects of a level are independent,
+ * so that large levels can be split between the threads of a {@link
+ * WorkerPool}.
+ *
+ * The objects remain the interface to the hierarchy: their local
+ * transformations are read from them, and their matrices are written back to
+ * them when they change. The hierarchy must be rebuilt with {@link #rebuild}
+ * after objects are added or removed, and after objects are updated through
+ * other means, such as {@link Rasterizer#render(Scene &, Camera &,
+ * RenderTarget<BufferType> &)}.
+ *
+ * \ingroup renderers
+ */
+class TransformHierarchy {
+public:
+  /**
+   * The minimum number of objects in a level for it to be split between
+   * threads.
+   */
+  static constexpr int parallelLevelSize = 1024;
+
+  Object3D &root; /**< The root of the hierarchy, usually a scene. */
+  std::vector<std::reference_wrapper<Mesh>>
+      meshes; /**< The meshes of the hierarchy, in the order that the
+                 rasterizer traverses the scene graph in. */
+  std::vector<std::reference_wrapper<Light>>
+      lights; /**< The lights of the hierarchy, in the same order. */
+
+  /**
+   * Creates a new flattened hierarchy of the descendants of an object.
+   *
+   * @param _root The root of the hierarchy.
+   */
+  explicit TransformHierarchy(Object3D &_root) : root(_root) { rebuild(); }
+
+  /**
+   * Returns the number of objects in this hierarchy, including the root.
+   */
+  int objectCount() const { return static_cast<int>(objects.size()); }
+
+  /**
+   * Flattens the hierarchy again from the scene graph. Like the rasterizer,
+   * the children of meshes are not part of the hierarchy.
+   */
+  void rebuild() {
+    objects.clear();
+    parents.clear();
+    levels.clear();
+    meshes.clear();
+    lights.clear();
+
+    // Add the objects level by level
+
+    objects.push_back(root);
+    parents.push_back(-1);
+
+    for (int levelStart = 0; levelStart < objectCount();) {
+      const auto levelEnd = objectCount();
+
+      levels.push_back(levelStart);
+
+      for (int i = levelStart; i < levelEnd; i++) {
+        Object3D &object = objects[i];
+
+        if (i > 0 && object.isMesh()) {
+          continue;
+        }
+
+        for (Object3D &child : object.children) {
+          objects.push_back(child);
+          parents.push_back(i);
+        }
+      }
+
+      levelStart = levelEnd;
+    }
+
+    levels.push_back(objectCount());
+
+    firstLeaf = 0;
+
+    for (int i = 0; i < objectCount(); i++) {
+      if (parents[i] >= firstLeaf) {
+        firstLeaf = parents[i] + 1;
+      }
+    }
+
+    modelMatrices.assign(firstLeaf, Matrix4x4::identity());
+    changed.assign(objects.size(), true);
+    updated = false;
+
+    collectMeshesAndLights();
+  }
+
+  /**
+   * Updates the local and model matrices of the objects whose transformations,
+   * or those of their ancestors, changed since the last update.
+   */
+  void update() {
+    for (int i = 0; i < objectCount(); i++) {
+      updateObject(i);
+    }
+
+    updated = true;
+  }
+
+  /**
+   * Updates the matrices like {@link #update()}, splitting the large levels of
+   * the hierarchy between the threads of a worker pool.
+   *
+   * @param workerPool The threads to update the matrices with.
+   */
+  void update(WorkerPool &workerPool) {
+    for (std::size_t level = 0; level + 1 < levels.size(); level++) {
+      const auto levelStart = levels[level];
+      const auto levelEnd = levels[level + 1];
+
+      if (workerPool.threadCount < 2 ||
+          levelEnd - levelStart < parallelLevelSize) {
+        for (int i = levelStart; i < levelEnd; i++) {
+          updateObject(i);
+        }
+
+        continue;
+      }
+
+      std::atomic<int> nextChunk = levelStart;
+
+      const auto worker = [&] {
+        for (int chunkStart = nextChunk.fetch_add(chunkSize);
+             chunkStart < levelEnd;
+             chunkStart = nextChunk.fetch_add(chunkSize)) {
+          const auto chunkEnd = std::min(chunkStart + chunkSize, levelEnd);
+
+          for (int i = chunkStart; i < chunkEnd; i++) {
+            updateObject(i);
+          }
+        }
+      };
+
+      workerPool.run(worker);
+    }
+
+    updated = true;
+  }
+
+private:
+  static constexpr int chunkSize = 256;
+
+  std::vector<std::reference_wrapper<Object3D>> objects; // Level by level
+  std::vector<int> parents; // The index of the parent; -1 for the root
+  std::vector<int> levels;  // The index of the first object of every level,
+                            // followed by the number of objects
+  std::vector<Matrix4x4> modelMatrices; // Of the objects before firstLeaf
+  int firstLeaf = 0; // The index after the last object with children
+  std::vector<char> changed; // Whether the model matrix changed in the last
+                             // update
+  bool updated = false;      // Whether the objects were updated since the
+                             // last rebuild
+
+  /**
+   * Updates the matrices of an object, whose parent is already up to date.
+   */
+  void updateObject(int index) {
+    Object3D &object = objects[index];
+
+    object.updateLocalMatrix();
+
+    if (index == 0) {
+      // The parent of the root, if any, is outside the hierarchy
+
+      const auto version = object.modelMatrixVersion;
+
+      object.updateModelMatrix();
+      changed[index] = !updated || object.modelMatrixVersion != version;
+    } else {
+      const auto parent = parents[index];
+      const Object3D &parentObject = objects[parent];
+
+      changed[index] = !updated || object.localMatrixChanged ||
+                       changed[parent] ||
+                       object.matrixParent != &parentObject;
+
+      if (changed[index]) {
+        object.setModelMatrix(modelMatrices[parent] * object.localMatrix,
+                              &parentObject);
+      }
+    }
+
+    // Only the model matrices of parents are read back from the array
+
+    if (changed[index] && index < firstLeaf) {
+      modelMatrices[index] = object.modelMatrix;
+    }
+  }
+
+  /**
+   * Lists the meshes and lights in the order of the traversal of the
+   * rasterizer, so that rendering the hierarchy draws the meshes in the same
+   * order as rendering the scene graph.
+   */
+  void collectMeshesAndLights() {
+    std::stack<std::reference_wrapper<Object3D>> stack;
+    stack.push(root);
+
+    while (!stack.empty()) {
+      Object3D &parent = stack.top();
+      stack.pop();
+
+      for (Object3D &child : parent.children) {
+        if (child.isMesh()) {
+          meshes.push_back(static_cast<Mesh &>(child));
+        } else {
+          stack.push(child);
+
+          if (child.isLight()) {
+            lights.push_back(static_cast<Light &>(child));
+          }
+        }
+      }
+    }
+  }
+};
+
+} // namespace t
+
+#endif // TRANSFORMHIERARCHY_HPP
@@ -0,0 +1,120 @@
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifndef WORKERPOOL_HPP
+#define WORKERPOOL_HPP
+
+namespace t {
+
+/**
+ * A fixed set of threads that run the same job together, kept alive between
+ * jobs so that running a job neither creates threads nor allocates memory.
+ *
+ * \ingroup renderers
+ */
+class WorkerPool {
+public:
+  const int threadCount; /**< The number of threads that run every job,
+                            including the calling thread. */
+
+  /**
+   * Creates a new pool that runs jobs on the specified number of threads,
+   * including the calling thread.
+   *
+   * @param _threadCount The number of threads to run jobs on.
+   */
+  explicit WorkerPool(int _threadCount) : threadCount(_threadCount) {
+    for (int i = 1; i < threadCount; i++) {
+      threads.emplace_back([this] { work(); });
+    }
+  }
+
+  WorkerPool(const WorkerPool &) = delete;
+  WorkerPool &operator=(const WorkerPool &) = delete;
+
+  ~WorkerPool() {
+    {
+      std::lock_guard lock(mutex);
+      stopping = true;
+    }
+
+    jobStarted.notify_all();
+
+    for (auto &thread : threads) {
+      thread.join();
+    }
+  }
+
+  /**
+   * Runs a job on every thread of the pool at once, and waits until it
+   * returns on all of them.
+   *
+   * @param job A function called without arguments on every thread, which
+   * must be safe to call concurrently.
+   */
+  template <class Job> void run(const Job &job) {
+    if (threads.empty()) {
+      job();
+      return;
+    }
+
+    {
+      std::lock_guard lock(mutex);
+      currentJob = &job;
+      runJob = [](const void *function) {
+        (*static_cast<const Job *>(function))();
+      };
+      runningCount = static_cast<int>(threads.size());
+      generation++;
+    }
+
+    jobStarted.notify_all();
+    job();
+
+    std::unique_lock lock(mutex);
+    jobFinished.wait(lock, [this] { return runningCount == 0; });
+  }
+
+private:
+  std::vector<std::thread> threads; // The threads besides the calling thread
+  std::mutex mutex;
+  std::condition_variable jobStarted;
+  std::condition_variable jobFinished;
+  const void *currentJob = nullptr;
+  void (*runJob)(const void *) = nullptr;
+  int runningCount = 0; // The threads that have not finished the job yet
+  long generation = 0;  // The number of jobs started
+  bool stopping = false;
+
+  void work() {
+    long finishedGeneration = 0;
+
+    while (true) {
+      std::unique_lock lock(mutex);
+      jobStarted.wait(lock, [&] {
+        return stopping || generation != finishedGeneration;
+      });
+
+      if (stopping) {
+        return;
+      }
+
+      finishedGeneration = generation;
+      lock.unlock();
+
+      runJob(currentJob);
+
+      lock.lock();
+
+      if (--runningCount == 0) {
+        jobFinished.notify_one();
+      }
+    }
+  }
+};
+
+} // namespace t
+
+#endif // WORKERPOOL_HPP
@@ -6,15 +6,20 @@
 #include "geometries/Box.hpp"
 #include "geometries/Geometry.hpp"
 #include "geometries/Plane.hpp"
+#include "geometries/SimplifiedGeometry.hpp"
 #include "geometries/UtahTeapot.hpp"
 #include "lights/AmbientLight.hpp"
 #include "lights/Light.hpp"
+#include "lights/LightList.hpp"
 #include "lights/PointLight.hpp"
 #include "materials/BlinnPhong.hpp"
 #include "materials/Material.hpp"
 #include "materials/NormalColor.hpp"
 #include "materials/SolidColor.hpp"
+#include "math/BoundingBox.hpp"
+#include "math/BoundingSphere.hpp"
 #include "math/EulerRotation.hpp"
+#include "math/Frustum.hpp"
 #include "math/Matrix3x3.hpp"
 #include "math/Matrix4x4.hpp"
 #include "math/Vector3.hpp"
@@ -23,6 +28,8 @@
 #include "primitives/BufferAttribute.hpp"
 #include "primitives/Color.hpp"
 #include "primitives/Fragment.hpp"
+#include "primitives/FragmentBatch.hpp"
+#include "primitives/InstancedMesh.hpp"
 #include "primitives/Mesh.hpp"
 #include "primitives/Object3D.hpp"
 #include "primitives/RenderTarget.hpp"
@@ -30,7 +37,18 @@
 #include "primitives/Texture.hpp"
 #include "primitives/Uniforms.hpp"
 #include "primitives/Varyings.hpp"
+#include "renderers/FrameArena.hpp"
+#include "renderers/GBuffer.hpp"
+#include "renderers/HierarchicalDepthBuffer.hpp"
+#include "renderers/LightGrid.hpp"
+#include "renderers/OcclusionBuffer.hpp"
 #include "renderers/Rasterizer.hpp"
+#include "renderers/RenderStats.hpp"
+#include "renderers/SceneBvh.hpp"
+#include "renderers/SpanKernel.hpp"
+#include "renderers/StaticBatcher.hpp"
+#include "renderers/TransformHierarchy.hpp"
+#include "renderers/WorkerPool.hpp"
 
 /**
  * \file t.hpp
@@ -0,0 +1,160 @@
+#include "algorithms.hpp"
+#include <array>
+#include <cstdint>
+#include <gtest/gtest.h>
+
+namespace {
+
+constexpr int gridSize = 12;
+
+using CoverageGrid = std::array<std::array<int, gridSize>, gridSize>;
+
+struct Point {
+  double x;
+  double y;
+};
+
+/**
+ * Adds 1 to the pixels of a grid whose centers a triangle covers, set up the
+ * way the rasterizer sets it up.
+ */
+void cover(const Point &a, const Point &b, const Point &c, CoverageGrid &grid) {
+  const auto xA = t::toSubpixel(a.x), yA = t::toSubpixel(a.y);
+  const auto xB = t::toSubpixel(b.x), yB = t::toSubpixel(b.y);
+  const auto xC = t::toSubpixel(c.x), yC = t::toSubpixel(c.y);
+
+  auto edgeBC = t::FixedPointEdgeFunction(xB, yB, xC, yC);
+  auto edgeCA = t::FixedPointEdgeFunction(xC, yC, xA, yA);
+  auto edgeAB = t::FixedPointEdgeFunction(xA, yA, xB, yB);
+
+  if (edgeAB.a * xC + edgeAB.b * yC + edgeAB.c < 0) {
+    edgeBC.negate();
+    edgeCA.negate();
+    edgeAB.negate();
+  }
+
+  edgeBC.applyTopLeftRule();
+  edgeCA.applyTopLeftRule();
+  edgeAB.applyTopLeftRule();
+
+  for (int y = 0; y < gridSize; y++) {
+    for (int x = 0; x < gridSize; x++) {
+      if (edgeBC(x, y) >= 0 && edgeCA(x, y) >= 0 && edgeAB(x, y) >= 0) {
+        grid[y][x]++;
+      }
+    }
+  }
+}
+
+/**
+ * Returns whether the center of a pixel is strictly inside a convex
+ * quadrilateral, whose vertices are in counterclockwise order.
+ */
+bool isInside(const std::array<Point, 4> &quad, int x, int y) {
+  for (int i = 0; i < 4; i++) {
+    const auto &p = quad[i];
+    const auto &q = quad[(i + 1) % 4];
+    const auto edge =
+        t::FixedPointEdgeFunction(t::toSubpixel(p.x), t::toSubpixel(p.y),
+                                  t::toSubpixel(q.x), t::toSubpixel(q.y));
+
+    if (edge(x, y) <= 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * Splits a convex quadrilateral into two triangles along the diagonal from
+ * its first to its third vertex, with either winding, and expects every pixel
+ * inside the quadrilateral, including those on the diagonal, to be covered
+ * exactly once, and no pixel to be covered twice.
+ */
+void expectCoveredOnce(const std::array<Point, 4> &quad) {
+  for (const auto clockwise : {false, true}) {
+    CoverageGrid grid{};
+
+    if (clockwise) {
+      cover(quad[0], quad[2], quad[1], grid);
+      cover(quad[0], quad[3], quad[2], grid);
+    } else {
+      cover(quad[0], quad[1], quad[2], grid);
+      cover(quad[0], quad[2], quad[3], grid);
+    }
+
+    for (int y = 0; y < gridSize; y++) {
+      for (int x = 0; x < gridSize; x++) {
+        if (isInside(quad, x, y)) {
+          EXPECT_EQ(grid[y][x], 1) << "pixel (" << x << ", " << y << ")";
+        } else {
+          EXPECT_LE(grid[y][x], 1) << "pixel (" << x << ", " << y << ")";
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
+TEST(FixedPointEdgeFunctionTests, ToSubpixel) {
+  EXPECT_EQ(t::toSubpixel(0), 0);
+  EXPECT_EQ(t::toSubpixel(3), 3 << t::subpixelBits);
+  EXPECT_EQ(t::toSubpixel(-2), -(2 << t::subpixelBits));
+  EXPECT_EQ(t::toSubpixel(3.5), 7 << (t::subpixelBits - 1));
+  EXPECT_EQ(t::toSubpixel(-0.25), -(1 << (t::subpixelBits - 2)));
+  EXPECT_EQ(t::toSubpixel(1.0 / (1 << t::subpixelBits)), 1);
+
+  // Coordinates between sub-pixels round to the nearest one
+
+  EXPECT_EQ(t::toSubpixel(0.4 / (1 << t::subpixelBits)), 0);
+  EXPECT_EQ(t::toSubpixel(1.6 / (1 << t::subpixelBits)), 2);
+}
+
+TEST(FixedPointEdgeFunctionTests, EvaluatesAtPixelCenters) {
+  const auto edge = t::FixedPointEdgeFunction(
+      t::toSubpixel(0), t::toSubpixel(0), t::toSubpixel(4), t::toSubpixel(0));
+
+  EXPECT_EQ(edge(2, 0), 0);
+  EXPECT_GT(edge(2, 1), 0);
+  EXPECT_LT(edge(2, -1), 0);
+  EXPECT_EQ(edge(3, 1) - edge(2, 1), edge.stepX());
+}
+
+TEST(FixedPointEdgeFunctionTests, TopLeftRule) {
+  // The inside of these edges is positive; only a left edge (a > 0) or a top
+  // edge (a = 0, b < 0) keeps the points on it
+
+  auto left = t::FixedPointEdgeFunction(0, 256, 0, 0);
+  auto right = t::FixedPointEdgeFunction(0, 0, 0, 256);
+  auto top = t::FixedPointEdgeFunction(256, 0, 0, 0);
+  auto bottom = t::FixedPointEdgeFunction(0, 0, 256, 0);
+
+  EXPECT_EQ(left.applyTopLeftRule()(0, 0), 0);
+  EXPECT_LT(right.applyTopLeftRule()(0, 0), 0);
+  EXPECT_EQ(top.applyTopLeftRule()(0, 0), 0);
+  EXPECT_LT(bottom.applyTopLeftRule()(0, 0), 0);
+}
+
+TEST(FixedPointEdgeFunctionTests, SharedDiagonalEdge) {
+  // Vertices at pixel centers, so that pixel centers lie on every edge
+
+  expectCoveredOnce({Point{1, 1}, Point{9, 1}, Point{9, 9}, Point{1, 9}});
+  expectCoveredOnce({Point{1, 9}, Point{1, 1}, Point{9, 1}, Point{9, 9}});
+}
+
+TEST(FixedPointEdgeFunctionTests, SharedHorizontalEdge) {
+  expectCoveredOnce({Point{1, 5}, Point{5, 1}, Point{10, 5}, Point{5, 10}});
+}
+
+TEST(FixedPointEdgeFunctionTests, SharedVerticalEdge) {
+  expectCoveredOnce({Point{5, 1}, Point{10, 5}, Point{5, 10}, Point{1, 5}});
+}
+
+TEST(FixedPointEdgeFunctionTests, SharedEdgeBetweenSubpixels) {
+  expectCoveredOnce(
+      {Point{0.3, 0.7}, Point{10.6, 1.2}, Point{9.9, 10.4}, Point{1.1, 9.8}});
+  expectCoveredOnce({Point{2.5, 0.5}, Point{10.5, 5.5}, Point{2.5, 10.5},
+                     Point{0.5, 5.5}});
+}
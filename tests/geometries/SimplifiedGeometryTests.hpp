@@ -0,0 +1,160 @@
+#include "geometries/Geometry.hpp"
+#include "geometries/SimplifiedGeometry.hpp"
+#include "geometries/UtahTeapot.hpp"
+#include "math/BoundingBox.hpp"
+#include "math/BoundingSphere.hpp"
+#include "math/Vector3.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <vector>
+
+namespace {
+
+int triangleCount(const t::Geometry &geometry) {
+  return geometry.faceIndices
+             ? static_cast<int>(geometry.faceIndices->array.size() / 3)
+             : static_cast<int>(geometry.vertexPositions.array.size() / 9);
+}
+
+bool hasVertexAt(const t::Geometry &geometry, const t::Vector3 &position) {
+  const auto vertexCount =
+      static_cast<int>(geometry.vertexPositions.array.size() / 3);
+
+  for (int i = 0; i < vertexCount; i++) {
+    if (t::Vector3::fromBufferAttribute(geometry.vertexPositions, i) ==
+        position) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ * Creates an open, indexed grid of (2n + 1) × (n + 1) vertices folded into a
+ * roof along its middle column: the vertices of the ridge are duplicated, with
+ * the normal of each side.
+ */
+t::Geometry roof(int n) {
+  std::vector<double> positions;
+  std::vector<double> normals;
+  std::vector<int> indices;
+
+  for (const auto side : {-1, 1}) {
+    const auto normal = t::Vector3(0.5 * side, 0, 1).normalize();
+    const auto first = static_cast<int>(positions.size() / 3);
+
+    for (int j = 0; j <= n; j++) {
+      for (int k = 0; k <= n; k++) {
+        const auto i = side * k;
+
+        positions.insert(positions.end(), {double(i), double(j), -0.5 * k});
+        normals.insert(normals.end(), {normal.x, normal.y, normal.z});
+      }
+    }
+
+    const auto at = [&](int k, int j) { return first + k + j * (n + 1); };
+
+    for (int j = 0; j < n; j++) {
+      for (int k = 0; k < n; k++) {
+        // Counterclockwise seen from +Z on both sides
+
+        if (side > 0) {
+          indices.insert(indices.end(), {at(k, j), at(k + 1, j), at(k, j + 1)});
+          indices.insert(indices.end(),
+                         {at(k + 1, j), at(k + 1, j + 1), at(k, j + 1)});
+        } else {
+          indices.insert(indices.end(), {at(k, j), at(k, j + 1), at(k + 1, j)});
+          indices.insert(indices.end(),
+                         {at(k + 1, j), at(k, j + 1), at(k + 1, j + 1)});
+        }
+      }
+    }
+  }
+
+  auto geometry = t::Geometry(t::BufferAttribute<double>({}, 3),
+                              t::BufferAttribute<double>({}, 3));
+  geometry.vertexPositions.array = positions;
+  geometry.vertexNormals.array = normals;
+  geometry.setIndices(t::BufferAttribute<int>({}, 3));
+  geometry.faceIndices->array = indices;
+
+  return geometry;
+}
+
+} // namespace
+
+TEST(SimplifiedGeometryTests, TriangleCount) {
+  const auto teapot = t::UtahTeapot();
+  const auto sourceCount = triangleCount(teapot);
+
+  for (const auto ratio : {0.5, 0.25, 0.1}) {
+    const auto simplified = t::SimplifiedGeometry(teapot, ratio);
+    const auto target = static_cast<int>(std::ceil(ratio * sourceCount));
+
+    EXPECT_LE(triangleCount(simplified), target) << "ratio " << ratio;
+    EXPECT_GE(triangleCount(simplified), target * 0.95) << "ratio " << ratio;
+  }
+
+  // The teapot cannot be simplified further than this, whatever the ratio
+
+  EXPECT_EQ(triangleCount(t::SimplifiedGeometry(teapot, 0.05)), 316);
+  EXPECT_EQ(triangleCount(t::SimplifiedGeometry(teapot, 0)), 316);
+}
+
+TEST(SimplifiedGeometryTests, StaysWithinBoundingVolumes) {
+  auto teapot = t::UtahTeapot();
+  teapot.computeBoundingBox();
+  teapot.computeBoundingSphere();
+
+  for (const auto ratio : {0.5, 0.1, 0.0}) {
+    const auto simplified = t::SimplifiedGeometry(teapot, ratio);
+    const auto vertexCount =
+        static_cast<int>(simplified.vertexPositions.array.size() / 3);
+
+    for (int i = 0; i < vertexCount; i++) {
+      const auto position =
+          t::Vector3::fromBufferAttribute(simplified.vertexPositions, i);
+
+      EXPECT_TRUE(teapot.boundingBox->containsPoint(position));
+      EXPECT_TRUE(teapot.boundingSphere->containsPoint(position));
+    }
+  }
+}
+
+TEST(SimplifiedGeometryTests, LocksBoundariesAndSeams) {
+  const auto n = 6;
+  const auto geometry = roof(n);
+  const auto simplified = t::SimplifiedGeometry(geometry, 0);
+
+  EXPECT_LT(triangleCount(simplified), triangleCount(geometry));
+
+  for (int i = -n; i <= n; i++) {
+    for (int j = 0; j <= n; j++) {
+      const auto isBoundary = std::abs(i) == n || j == 0 || j == n;
+      const auto isSeam = i == 0;
+
+      if (isBoundary || isSeam) {
+        EXPECT_TRUE(
+            hasVertexAt(simplified, t::Vector3(i, j, -0.5 * std::abs(i))))
+            << "vertex (" << i << ", " << j << ")";
+      }
+    }
+  }
+
+  // The seam keeps the normals of both sides
+
+  const auto vertexCount =
+      static_cast<int>(simplified.vertexPositions.array.size() / 3);
+  auto seamNormalCount = 0;
+
+  for (int i = 0; i < vertexCount; i++) {
+    if (simplified.vertexPositions.array[i * 3] == 0 &&
+        simplified.vertexPositions.array[i * 3 + 1] == 1) {
+      seamNormalCount++;
+    }
+  }
+
+  EXPECT_EQ(seamNormalCount, 2);
+}
@@ -1,9 +1,19 @@
 #include "gtest/gtest.h"
 
+#include "FixedPointEdgeFunctionTests.hpp"
+#include "geometries/SimplifiedGeometryTests.hpp"
+#include "math/BoundingBoxTests.hpp"
+#include "math/BoundingSphereTests.hpp"
+#include "math/FrustumTests.hpp"
 #include "math/Matrix3x3Tests.hpp"
 #include "math/Matrix4x4Tests.hpp"
 #include "math/Vector3Tests.hpp"
 #include "math/Vector4Tests.hpp"
+#include "primitives/InstancedMeshTests.hpp"
+#include "primitives/Object3DTests.hpp"
+#include "renderers/FrameArenaTests.hpp"
+#include "renderers/LightGridTests.hpp"
+#include "renderers/RasterizerTests.hpp"
 
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
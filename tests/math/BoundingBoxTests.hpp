@@ -0,0 +1,98 @@
+#include "math/BoundingBox.hpp"
+#include <gtest/gtest.h>
+
+TEST(BoundingBoxTests, Constructor) {
+  const auto box = t::BoundingBox(t::Vector3(1, 2, 3), t::Vector3(4, 5, 6));
+
+  EXPECT_EQ(box.min, t::Vector3(1, 2, 3));
+  EXPECT_EQ(box.max, t::Vector3(4, 5, 6));
+  EXPECT_FALSE(box.isEmpty());
+}
+
+TEST(BoundingBoxTests, Empty) {
+  const auto box = t::BoundingBox();
+
+  EXPECT_TRUE(box.isEmpty());
+  EXPECT_FALSE(box.containsPoint(t::Vector3(0, 0, 0)));
+}
+
+TEST(BoundingBoxTests, ExpandByPoint) {
+  auto box = t::BoundingBox();
+  box.expandByPoint(t::Vector3(1, -2, 3));
+
+  EXPECT_FALSE(box.isEmpty());
+  EXPECT_EQ(box.min, t::Vector3(1, -2, 3));
+  EXPECT_EQ(box.max, t::Vector3(1, -2, 3));
+
+  box.expandByPoint(t::Vector3(-1, 2, 0));
+
+  EXPECT_EQ(box.min, t::Vector3(-1, -2, 0));
+  EXPECT_EQ(box.max, t::Vector3(1, 2, 3));
+}
+
+TEST(BoundingBoxTests, FromBufferAttribute) {
+  const auto positions =
+      t::BufferAttribute<double>({0, 1, 0, -1, 0, 0, 1, 0, 2}, 3);
+  const auto box = t::BoundingBox::fromBufferAttribute(positions);
+
+  EXPECT_EQ(box.min, t::Vector3(-1, 0, 0));
+  EXPECT_EQ(box.max, t::Vector3(1, 1, 2));
+}
+
+TEST(BoundingBoxTests, ContainsPoint) {
+  const auto box = t::BoundingBox(t::Vector3(0, 0, 0), t::Vector3(1, 1, 1));
+
+  EXPECT_TRUE(box.containsPoint(t::Vector3(0.5, 0.5, 0.5)));
+  EXPECT_TRUE(box.containsPoint(t::Vector3(1, 0, 1)));
+  EXPECT_FALSE(box.containsPoint(t::Vector3(1.5, 0.5, 0.5)));
+}
+
+TEST(BoundingBoxTests, Corners) {
+  const auto box = t::BoundingBox(t::Vector3(0, 0, 0), t::Vector3(1, 2, 3));
+  const auto corners = box.corners();
+
+  for (const auto &corner : corners) {
+    EXPECT_TRUE(box.containsPoint(corner));
+    EXPECT_TRUE(corner.x == 0 || corner.x == 1);
+    EXPECT_TRUE(corner.y == 0 || corner.y == 2);
+    EXPECT_TRUE(corner.z == 0 || corner.z == 3);
+  }
+
+  EXPECT_EQ(corners[0], box.min);
+  EXPECT_EQ(corners[7], box.max);
+}
+
+TEST(BoundingBoxTests, ExpandByBox) {
+  auto box = t::BoundingBox();
+  box.expandByBox(t::BoundingBox(t::Vector3(0, 0, 0), t::Vector3(1, 1, 1)));
+
+  EXPECT_EQ(box.min, t::Vector3(0, 0, 0));
+  EXPECT_EQ(box.max, t::Vector3(1, 1, 1));
+
+  box.expandByBox(t::BoundingBox(t::Vector3(-1, 0.5, 0), t::Vector3(0, 2, 1)));
+
+  EXPECT_EQ(box.min, t::Vector3(-1, 0, 0));
+  EXPECT_EQ(box.max, t::Vector3(1, 2, 1));
+
+  box.expandByBox(t::BoundingBox());
+
+  EXPECT_EQ(box.min, t::Vector3(-1, 0, 0));
+  EXPECT_EQ(box.max, t::Vector3(1, 2, 1));
+}
+
+TEST(BoundingBoxTests, Center) {
+  const auto box = t::BoundingBox(t::Vector3(-1, 0, 2), t::Vector3(1, 4, 3));
+
+  EXPECT_EQ(box.center(), t::Vector3(0, 2, 2.5));
+}
+
+TEST(BoundingBoxTests, Transform) {
+  const auto box = t::BoundingBox(t::Vector3(0, 0, 0), t::Vector3(1, 2, 3));
+  const auto transformed =
+      box.transform(t::Matrix4x4::fromTranslation(t::Vector3(1, 0, 0)) *
+                    t::Matrix4x4::fromScale(t::Vector3(2, -1, 1)));
+
+  EXPECT_EQ(transformed.min, t::Vector3(1, -2, 0));
+  EXPECT_EQ(transformed.max, t::Vector3(3, 0, 3));
+  EXPECT_TRUE(t::BoundingBox().transform(t::Matrix4x4::identity()).isEmpty());
+}
@@ -0,0 +1,50 @@
+#include "math/BoundingSphere.hpp"
+#include <gtest/gtest.h>
+
+TEST(BoundingSphereTests, Constructor) {
+  const auto sphere = t::BoundingSphere(t::Vector3(1, 2, 3), 4);
+
+  EXPECT_EQ(sphere.center, t::Vector3(1, 2, 3));
+  EXPECT_EQ(sphere.radius, 4);
+  EXPECT_FALSE(sphere.isEmpty());
+}
+
+TEST(BoundingSphereTests, Empty) {
+  const auto sphere = t::BoundingSphere();
+
+  EXPECT_TRUE(sphere.isEmpty());
+  EXPECT_FALSE(sphere.containsPoint(t::Vector3(0, 0, 0)));
+}
+
+TEST(BoundingSphereTests, FromBufferAttribute) {
+  const auto positions =
+      t::BufferAttribute<double>({-1, 0, 0, 1, 0, 0, 0, 1, 0, 0, -1, 0}, 3);
+  const auto sphere = t::BoundingSphere::fromBufferAttribute(positions);
+
+  EXPECT_EQ(sphere.center, t::Vector3(0, 0, 0));
+  EXPECT_DOUBLE_EQ(sphere.radius, 1);
+
+  const auto empty =
+      t::BoundingSphere::fromBufferAttribute(t::BufferAttribute<double>({}, 3));
+
+  EXPECT_TRUE(empty.isEmpty());
+}
+
+TEST(BoundingSphereTests, ContainsPoint) {
+  const auto sphere = t::BoundingSphere(t::Vector3(1, 0, 0), 1);
+
+  EXPECT_TRUE(sphere.containsPoint(t::Vector3(1, 0.5, 0)));
+  EXPECT_TRUE(sphere.containsPoint(t::Vector3(2, 0, 0)));
+  EXPECT_FALSE(sphere.containsPoint(t::Vector3(-0.5, 0, 0)));
+}
+
+TEST(BoundingSphereTests, Transform) {
+  const auto sphere = t::BoundingSphere(t::Vector3(1, 0, 0), 1);
+  const auto matrix = t::Matrix4x4::fromTranslation(t::Vector3(0, 2, 0)) *
+                      t::Matrix4x4::fromScale(t::Vector3(1, 3, 2));
+  const auto transformed = sphere.transform(matrix);
+
+  EXPECT_EQ(transformed.center, t::Vector3(1, 2, 0));
+  EXPECT_DOUBLE_EQ(transformed.radius, 3);
+  EXPECT_TRUE(t::BoundingSphere().transform(matrix).isEmpty());
+}
@@ -0,0 +1,46 @@
+#include "math/Frustum.hpp"
+#include <gtest/gtest.h>
+
+TEST(FrustumTests, FromMatrix) {
+  // The frustum of the identity matrix is the NDC cube
+  const auto frustum = t::Frustum::fromMatrix(t::Matrix4x4::identity());
+
+  EXPECT_EQ(frustum.planes[0], t::Vector4(1, 0, 0, 1));
+  EXPECT_EQ(frustum.planes[1], t::Vector4(-1, 0, 0, 1));
+  EXPECT_EQ(frustum.planes[2], t::Vector4(0, 1, 0, 1));
+  EXPECT_EQ(frustum.planes[3], t::Vector4(0, -1, 0, 1));
+  EXPECT_EQ(frustum.planes[4], t::Vector4(0, 0, 1, 1));
+  EXPECT_EQ(frustum.planes[5], t::Vector4(0, 0, -1, 1));
+}
+
+TEST(FrustumTests, ContainsPoint) {
+  const auto frustum = t::Frustum::fromMatrix(
+      t::Matrix4x4::fromScale(t::Vector3(0.5, 0.5, 0.5)));
+
+  EXPECT_TRUE(frustum.containsPoint(t::Vector3(0, 0, 0)));
+  EXPECT_TRUE(frustum.containsPoint(t::Vector3(2, -2, 2)));
+  EXPECT_FALSE(frustum.containsPoint(t::Vector3(2.5, 0, 0)));
+  EXPECT_FALSE(frustum.containsPoint(t::Vector3(0, 0, -3)));
+}
+
+TEST(FrustumTests, IntersectsSphere) {
+  const auto frustum = t::Frustum::fromMatrix(t::Matrix4x4::identity());
+
+  EXPECT_TRUE(
+      frustum.intersectsSphere(t::BoundingSphere(t::Vector3(0, 0, 0), 0.5)));
+  EXPECT_TRUE(
+      frustum.intersectsSphere(t::BoundingSphere(t::Vector3(1.5, 0, 0), 1)));
+  EXPECT_FALSE(
+      frustum.intersectsSphere(t::BoundingSphere(t::Vector3(0, 2.5, 0), 1)));
+}
+
+TEST(FrustumTests, IntersectsBox) {
+  const auto frustum = t::Frustum::fromMatrix(t::Matrix4x4::identity());
+
+  EXPECT_TRUE(frustum.intersectsBox(
+      t::BoundingBox(t::Vector3(-2, -2, -2), t::Vector3(2, 2, 2))));
+  EXPECT_TRUE(frustum.intersectsBox(
+      t::BoundingBox(t::Vector3(0.5, 0.5, 0.5), t::Vector3(3, 3, 3))));
+  EXPECT_FALSE(frustum.intersectsBox(
+      t::BoundingBox(t::Vector3(-3, -3, 1.5), t::Vector3(3, 3, 3))));
+}
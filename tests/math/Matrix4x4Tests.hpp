@@ -462,4 +462,14 @@ TEST(Matrix4x4Tests, FromScale) {
   for (int i = 0; i < 16; i++) {
     EXPECT_DOUBLE_EQ(actual.elements[i], expected.elements[i]);
   }
-}
\ No newline at end of file
+}
+
+TEST(Matrix4x4Tests, MaxScaleOnAxis) {
+  const auto matrix =
+      t::Matrix4x4::fromRotation(t::EulerRotation(M_PI / 3, M_PI / 4, 0,
+                                                  t::EulerRotationOrder::Xyz)) *
+      t::Matrix4x4::fromScale(t::Vector3(2, -5, 3));
+
+  EXPECT_DOUBLE_EQ(matrix.maxScaleOnAxis(), 5);
+  EXPECT_DOUBLE_EQ(t::Matrix4x4::identity().maxScaleOnAxis(), 1);
+}
@@ -0,0 +1,91 @@
+#include "geometries/Box.hpp"
+#include "materials/NormalColor.hpp"
+#include "math/Matrix4x4.hpp"
+#include "math/Vector3.hpp"
+#include "primitives/InstancedMesh.hpp"
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+#include <vector>
+
+TEST(InstancedMeshTests, ComputeBoundingBox) {
+  auto box = t::Box(1, 1, 1);
+  auto material = t::NormalColor();
+  auto mesh = t::InstancedMesh(
+      box, material,
+      {t::Matrix4x4::fromTranslation(t::Vector3(2, 0, 0)),
+       t::Matrix4x4::fromTranslation(t::Vector3(0, 3, 0)) *
+           t::Matrix4x4::fromScale(t::Vector3(2, 2, 2))});
+
+  EXPECT_FALSE(mesh.boundingBox);
+
+  const auto &boundingBox = mesh.localBoundingBox();
+
+  EXPECT_EQ(boundingBox.min, t::Vector3(-1, -0.5, -1));
+  EXPECT_EQ(boundingBox.max, t::Vector3(2.5, 4, 1));
+
+  // Recomputed after the instance matrices change
+  mesh.instanceMatrices.pop_back();
+  mesh.computeBoundingBox();
+
+  EXPECT_EQ(mesh.boundingBox->min, t::Vector3(1.5, -0.5, -0.5));
+  EXPECT_EQ(mesh.boundingBox->max, t::Vector3(2.5, 0.5, 0.5));
+
+  mesh.instanceMatrices.clear();
+  mesh.computeBoundingBox();
+
+  EXPECT_TRUE(mesh.boundingBox->isEmpty());
+}
+
+TEST(InstancedMeshTests, ComputeBoundingSphere) {
+  auto box = t::Box(1, 1, 1);
+  auto material = t::NormalColor();
+  auto instanceMatrices = std::vector<t::Matrix4x4>();
+
+  for (int i = 0; i < 4; i++) {
+    instanceMatrices.push_back(
+        t::Matrix4x4::fromTranslation(t::Vector3(i, i % 2, -i)) *
+        t::Matrix4x4::fromScale(t::Vector3(1 + i, 1, 1)));
+  }
+
+  auto mesh = t::InstancedMesh(box, material, instanceMatrices);
+
+  EXPECT_FALSE(mesh.boundingSphere);
+
+  const auto &boundingSphere = mesh.localBoundingSphere();
+
+  EXPECT_EQ(boundingSphere.center, mesh.localBoundingBox().center());
+
+  // Contains every vertex of every instance
+  for (const auto &instanceMatrix : instanceMatrices) {
+    for (std::size_t i = 0; i < box.vertexPositions.array.size(); i += 3) {
+      const auto &positions = box.vertexPositions.array;
+      const auto vertex =
+          instanceMatrix * t::Vector4(positions[i], positions[i + 1],
+                                      positions[i + 2], 1);
+
+      EXPECT_LE((vertex.toVector3() - boundingSphere.center).length(),
+                boundingSphere.radius + 1e-12);
+    }
+  }
+
+  // As tight as the bounding spheres of the instances allow
+  const auto &geometrySphere = mesh.Mesh::localBoundingSphere();
+  double radius = 0;
+
+  for (const auto &instanceMatrix : instanceMatrices) {
+    const auto instanceSphere = geometrySphere.transform(instanceMatrix);
+
+    radius = std::max(radius,
+                      (instanceSphere.center - boundingSphere.center).length() +
+                          instanceSphere.radius);
+  }
+
+  EXPECT_DOUBLE_EQ(boundingSphere.radius, radius);
+
+  mesh.instanceMatrices.clear();
+  mesh.computeBoundingBox();
+  mesh.computeBoundingSphere();
+
+  EXPECT_TRUE(mesh.boundingSphere->isEmpty());
+}
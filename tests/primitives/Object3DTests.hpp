@@ -0,0 +1,143 @@
+#include "math/Matrix3x3.hpp"
+#include "math/Matrix4x4.hpp"
+#include "primitives/Object3D.hpp"
+#include <gtest/gtest.h>
+
+namespace {
+
+// Updates the local matrix and then the model matrix, in the order the
+// renderer does
+void update(t::Object3D &object) {
+  object.updateLocalMatrix().updateModelMatrix();
+}
+
+t::Matrix3x3 expectedNormalMatrix(const t::Matrix4x4 &modelMatrix) {
+  return modelMatrix.topLeft3x3Matrix().inverse().transpose();
+}
+
+} // namespace
+
+TEST(Object3DTests, UpdateLocalMatrix) {
+  auto object = t::Object3D();
+  object.translate(1, 2, 3).scale(2, 3, 4);
+  object.updateLocalMatrix();
+
+  EXPECT_EQ(object.localMatrix,
+            t::Matrix4x4::fromTranslation(t::Vector3(1, 2, 3)) *
+                t::Matrix4x4::fromScale(t::Vector3(2, 3, 4)));
+  // The model matrix waits for updateModelMatrix
+  EXPECT_EQ(object.modelMatrix, t::Matrix4x4::identity());
+
+  object.updateModelMatrix();
+
+  EXPECT_EQ(object.modelMatrix, object.localMatrix);
+  EXPECT_EQ(object.normalMatrix, expectedNormalMatrix(object.modelMatrix));
+}
+
+TEST(Object3DTests, MovingParentUpdatesChild) {
+  auto parent = t::Object3D();
+  auto child = t::Object3D();
+  auto grandchild = t::Object3D();
+  parent.add(child);
+  child.add(grandchild);
+  child.translate(1, 0, 0);
+  grandchild.translate(0, 1, 0);
+  update(parent);
+  update(child);
+  update(grandchild);
+
+  // Only the parent moves; the local matrices of the child and the grandchild
+  // stay the same
+  parent.translate(0, 0, 5).scale(1, 2, 4);
+  update(parent);
+  update(child);
+  update(grandchild);
+
+  EXPECT_EQ(child.modelMatrix, parent.modelMatrix * child.localMatrix);
+  EXPECT_EQ(child.normalMatrix, expectedNormalMatrix(child.modelMatrix));
+  EXPECT_EQ(grandchild.modelMatrix, child.modelMatrix * grandchild.localMatrix);
+  EXPECT_EQ(grandchild.normalMatrix,
+            expectedNormalMatrix(grandchild.modelMatrix));
+  EXPECT_NE(child.normalMatrix, t::Matrix3x3::identity());
+}
+
+TEST(Object3DTests, Reparenting) {
+  auto first = t::Object3D();
+  auto second = t::Object3D();
+  auto child = t::Object3D();
+  first.translate(1, 0, 0);
+  second.translate(0, 0, 1).scale(2, 2, 2);
+  first.add(child);
+  child.translate(0, 1, 0);
+  // Both parents are updated the same number of times, so their model matrix
+  // versions are the same
+  update(first);
+  update(second);
+  update(child);
+
+  first.children.clear();
+  second.add(child);
+  update(child);
+
+  EXPECT_EQ(child.modelMatrix, second.modelMatrix * child.localMatrix);
+  EXPECT_EQ(child.normalMatrix, expectedNormalMatrix(child.modelMatrix));
+
+  second.children.clear();
+  child.parent.reset();
+  update(child);
+
+  EXPECT_EQ(child.modelMatrix, child.localMatrix);
+  EXPECT_EQ(child.normalMatrix, expectedNormalMatrix(child.modelMatrix));
+}
+
+TEST(Object3DTests, RestoringTransform) {
+  auto parent = t::Object3D();
+  auto child = t::Object3D();
+  parent.add(child);
+  parent.translate(1, 2, 3);
+  child.scale(2, 2, 2);
+  update(parent);
+  update(child);
+  const auto localMatrix = child.localMatrix;
+  const auto modelMatrix = child.modelMatrix;
+  const auto normalMatrix = child.normalMatrix;
+
+  // Moved and restored between two updates
+  child.translate(4, 0, 0);
+  child.translate(-4, 0, 0);
+  update(parent);
+  update(child);
+
+  EXPECT_EQ(child.localMatrix, localMatrix);
+  EXPECT_EQ(child.modelMatrix, modelMatrix);
+  EXPECT_EQ(child.normalMatrix, normalMatrix);
+
+  // Moved, updated, then restored
+  child.translate(4, 0, 0).scale(0.5, 1, 1);
+  update(parent);
+  update(child);
+
+  EXPECT_NE(child.modelMatrix, modelMatrix);
+
+  child.translate(-4, 0, 0).scale(2, 1, 1);
+  update(parent);
+  update(child);
+
+  EXPECT_EQ(child.localMatrix, localMatrix);
+  EXPECT_EQ(child.modelMatrix, modelMatrix);
+  EXPECT_EQ(child.normalMatrix, normalMatrix);
+
+  // The same for the parent
+  parent.translate(0, 5, 0);
+  update(parent);
+  update(child);
+
+  EXPECT_NE(child.modelMatrix, modelMatrix);
+
+  parent.translate(0, -5, 0);
+  update(parent);
+  update(child);
+
+  EXPECT_EQ(child.modelMatrix, modelMatrix);
+  EXPECT_EQ(child.normalMatrix, normalMatrix);
+}
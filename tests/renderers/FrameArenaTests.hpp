@@ -0,0 +1,149 @@
+#include "renderers/FrameArena.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory_resource>
+
+namespace {
+
+/**
+ * A memory resource that counts the allocations made from it.
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+  int allocationCount = 0;
+  int deallocationCount = 0;
+
+protected:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+    allocationCount++;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void *pointer, std::size_t bytes,
+                     std::size_t alignment) override {
+    deallocationCount++;
+    std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override {
+    return this == &other;
+  }
+};
+
+// Allocates from the arena when only its bookkeeping matters
+void allocate(t::FrameArena &arena, std::size_t bytes, std::size_t alignment) {
+  EXPECT_NE(arena.allocate(bytes, alignment), nullptr);
+}
+
+bool isAligned(const void *pointer, std::size_t alignment) {
+  return reinterpret_cast<std::uintptr_t>(pointer) % alignment == 0;
+}
+
+} // namespace
+
+TEST(FrameArenaTests, Alignment) {
+  auto arena = t::FrameArena(1024);
+
+  allocate(arena, 1, 1);
+
+  EXPECT_TRUE(isAligned(arena.allocate(8, 8), 8));
+
+  allocate(arena, 3, 1);
+
+  EXPECT_TRUE(isAligned(arena.allocate(64, 64), 64));
+
+  // Over-aligned for the upstream resource, in the current block and in a new
+  // one
+
+  EXPECT_TRUE(isAligned(arena.allocate(16, 256), 256));
+  EXPECT_TRUE(isAligned(arena.allocate(4096, 512), 512));
+}
+
+TEST(FrameArenaTests, GrowsAndMergesBlocks) {
+  auto upstream = CountingResource();
+  auto arena = t::FrameArena(4096, &upstream);
+
+  EXPECT_EQ(upstream.allocationCount, 1);
+  EXPECT_EQ(arena.capacity(), 4096u);
+
+  allocate(arena, 3000, 8);
+  allocate(arena, 3000, 8); // Does not fit in the first block
+
+  EXPECT_EQ(upstream.allocationCount, 2);
+  EXPECT_GT(arena.capacity(), 4096u);
+
+  // Resetting merges the blocks into one that fits both allocations
+
+  const auto capacity = arena.capacity();
+  arena.reset();
+
+  EXPECT_EQ(upstream.allocationCount, 3);
+  EXPECT_EQ(upstream.deallocationCount, 2);
+  EXPECT_EQ(arena.capacity(), capacity);
+
+  allocate(arena, 3000, 8);
+  allocate(arena, 3000, 8);
+  arena.reset();
+
+  EXPECT_EQ(upstream.allocationCount, 3);
+}
+
+TEST(FrameArenaTests, UsedAndPeakUsage) {
+  auto arena = t::FrameArena(1024);
+
+  EXPECT_EQ(arena.used(), 0u);
+
+  allocate(arena, 10, 1);
+  allocate(arena, 8, 8); // After 6 bytes of padding
+
+  EXPECT_EQ(arena.used(), 24u);
+  EXPECT_EQ(arena.peakUsage(), 24u);
+
+  arena.reset();
+  allocate(arena, 16, 8);
+
+  EXPECT_EQ(arena.used(), 16u);
+  EXPECT_EQ(arena.peakUsage(), 24u);
+
+  allocate(arena, 100, 8);
+
+  EXPECT_EQ(arena.used(), 116u);
+  EXPECT_EQ(arena.peakUsage(), 116u);
+}
+
+TEST(FrameArenaTests, Reserve) {
+  auto upstream = CountingResource();
+  auto arena = t::FrameArena(1024, &upstream);
+
+  allocate(arena, 100, 8);
+  arena.reserve(512);
+
+  EXPECT_EQ(upstream.allocationCount, 1);
+  EXPECT_EQ(arena.capacity(), 1024u);
+  EXPECT_EQ(arena.used(), 0u);
+
+  arena.reserve(1024);
+
+  EXPECT_EQ(upstream.allocationCount, 1);
+
+  arena.reserve(8192);
+
+  EXPECT_EQ(upstream.allocationCount, 2);
+  EXPECT_EQ(upstream.deallocationCount, 1);
+  EXPECT_EQ(arena.capacity(), 8192u);
+}
+
+TEST(FrameArenaTests, ReleasesBlocks) {
+  auto upstream = CountingResource();
+
+  {
+    auto arena = t::FrameArena(64, &upstream);
+
+    allocate(arena, 5000, 8);
+  }
+
+  EXPECT_EQ(upstream.allocationCount, 2);
+  EXPECT_EQ(upstream.deallocationCount, 2);
+}
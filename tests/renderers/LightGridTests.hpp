@@ -0,0 +1,127 @@
+#include "cameras/PerspectiveCamera.hpp"
+#include "geometries/Plane.hpp"
+#include "lights/AmbientLight.hpp"
+#include "lights/PointLight.hpp"
+#include "materials/BlinnPhong.hpp"
+#include "primitives/Mesh.hpp"
+#include "primitives/RenderTarget.hpp"
+#include "primitives/Scene.hpp"
+#include "renderers/LightGrid.hpp"
+#include "renderers/Rasterizer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <gtest/gtest.h>
+
+namespace {
+
+/**
+ * Returns the largest difference between the components of two images.
+ */
+double maxDifference(const t::RenderTarget<double> &a,
+                     const t::RenderTarget<double> &b) {
+  double difference = 0;
+
+  for (std::size_t i = 0; i < a.texture.image.size(); i++) {
+    difference = std::max(
+        difference, std::abs(a.texture.image[i] - b.texture.image[i]));
+  }
+
+  return difference;
+}
+
+/**
+ * Renders a white wall facing the camera lit by a point light, with and
+ * without light culling, and returns the largest difference between the two
+ * images.
+ */
+double cullingError(t::PointLight &light, double cutoff) {
+  auto plane = t::Plane(20, 20);
+  auto material = t::BlinnPhong(t::Color(255, 255, 255),
+                                t::Color(255, 255, 255), 1);
+  auto wall = t::Mesh(plane, material);
+  auto camera = t::PerspectiveCamera(M_PI / 2, 1, 0.1, 100);
+  camera.translate(0, 0, 10);
+
+  auto scene = t::Scene();
+  scene.add(wall);
+  scene.add(light);
+  scene.add(camera);
+
+  auto renderer = t::Rasterizer();
+  auto all = t::RenderTarget<double>(64, 64, t::TextureFormat::RgbDouble);
+  auto culled = t::RenderTarget<double>(64, 64, t::TextureFormat::RgbDouble);
+
+  renderer.render(scene, camera, all);
+  renderer.lightCutoff = cutoff;
+  renderer.render(scene, camera, culled);
+
+  return maxDifference(all, culled);
+}
+
+} // namespace
+
+TEST(LightGridTests, InfluenceRadius) {
+  const auto light = t::PointLight(t::Color(255, 128, 0), 2);
+  const auto cutoff = 0.01;
+  const auto power = light.color.x * light.power(); // The largest component
+  const auto radius = t::LightGrid::influenceRadius(light, cutoff);
+
+  EXPECT_GE(radius, power / cutoff);
+  EXPECT_GE(radius, std::sqrt(power / cutoff));
+  EXPECT_NEAR(power / radius + power / (radius * radius), cutoff, 1e-12);
+  EXPECT_EQ(t::LightGrid::influenceRadius(light, 0), INFINITY);
+}
+
+TEST(LightGridTests, InfluenceRadiusBoundsBlinnPhong) {
+  // The fragment faces the light, and the camera is behind the light, so that
+  // both the diffuse and the specular terms are at their largest
+
+  auto light = t::PointLight(t::Color(255, 255, 255), 0.5);
+  auto material = t::BlinnPhong(t::Color(255, 255, 255),
+                                t::Color(255, 255, 255), 1);
+  const auto cutoff = 0.01;
+  const auto radius = t::LightGrid::influenceRadius(light, cutoff);
+
+  for (const auto distance : {radius, 2 * radius, 10 * radius}) {
+    light.localPosition = t::Vector3(0, 0, distance);
+    light.updateLocalMatrix().updateModelMatrix();
+
+    auto modelMatrix = t::Matrix4x4::identity();
+    auto modelViewMatrix = t::Matrix4x4::identity();
+    auto projectionMatrix = t::Matrix4x4::identity();
+    auto viewMatrix = t::Matrix4x4::identity();
+    auto normalMatrix = t::Matrix3x3::identity();
+    auto cameraPosition = t::Vector3(0, 0, 2 * distance);
+    const auto uniforms =
+        t::Uniforms{modelMatrix, modelViewMatrix, projectionMatrix,
+                    viewMatrix,  normalMatrix,    cameraPosition};
+    auto localPosition = t::Vector3(0, 0, 0);
+    auto localNormal = t::Vector3(0, 0, 1);
+    const auto varyings = t::Varyings{localPosition, localNormal};
+
+    const auto color = material.fragmentShader(uniforms, varyings, {light});
+    const auto maxComponent = std::max({color.x, color.y, color.z});
+
+    EXPECT_LE(maxComponent, cutoff * (1 + 1e-9));
+  }
+}
+
+TEST(LightGridTests, CulledLightAddsAtMostCutoff) {
+  // A weak light near the wall is culled from the tiles away from it
+
+  auto nearLight = t::PointLight(t::Color(255, 255, 255), 0.01);
+  nearLight.translate(5, 5, 0.5);
+
+  const auto nearError = cullingError(nearLight, 0.05);
+
+  EXPECT_GT(nearError, 0);
+  EXPECT_LE(nearError, 0.05);
+
+  // A light far behind the camera still lights the whole wall, since the
+  // diffuse term of BlinnPhong falls off with the distance
+
+  auto farLight = t::PointLight(t::Color(255, 255, 255), 1);
+  farLight.translate(0, 0, 160);
+
+  EXPECT_LE(cullingError(farLight, 0.01), 0.01);
+}
@@ -0,0 +1,507 @@
+#include "cameras/PerspectiveCamera.hpp"
+#include "geometries/Box.hpp"
+#include "geometries/Plane.hpp"
+#include "lights/AmbientLight.hpp"
+#include "lights/PointLight.hpp"
+#include "materials/BlinnPhong.hpp"
+#include "materials/NormalColor.hpp"
+#include "materials/SolidColor.hpp"
+#include "primitives/Color.hpp"
+#include "primitives/InstancedMesh.hpp"
+#include "primitives/Mesh.hpp"
+#include "primitives/RenderTarget.hpp"
+#include "primitives/Scene.hpp"
+#include "renderers/GBuffer.hpp"
+#include "renderers/Rasterizer.hpp"
+#include "renderers/SceneBvh.hpp"
+#include "renderers/SpanKernel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <gtest/gtest.h>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Not a multiple of the tile size, so that the tiles on the right and at the
+// bottom are partial
+constexpr int width = 150;
+constexpr int height = 100;
+
+/**
+ * Renders a scene, or the scene of a BVH, and returns the image.
+ */
+template <class SceneType>
+std::vector<double> render(t::Rasterizer &renderer, SceneType &scene,
+                           t::Camera &camera) {
+  auto renderTarget =
+      t::RenderTarget<double>(width, height, t::TextureFormat::RgbDouble);
+  renderer.render(scene, camera, renderTarget);
+
+  return renderTarget.texture.image;
+}
+
+/**
+ * Renders a small scene of overlapping lit meshes, with the rasterizer
+ * configured by the given function, and returns the image.
+ */
+std::vector<double>
+renderScene(const std::function<void(t::Rasterizer &)> &configure) {
+  auto plane = t::Plane(20, 20);
+  auto box = t::Box(0.8, 0.8, 0.8);
+  auto groundMaterial = t::BlinnPhong(t::Color(180, 180, 180),
+                                      t::Color(0, 0, 0), 0);
+  auto shinyMaterial = t::BlinnPhong(t::Color(0, 0, 200),
+                                     t::Color(255, 255, 255), 64);
+  auto normalMaterial = t::NormalColor();
+  auto ground = t::Mesh(plane, groundMaterial);
+  ground.translate(0, -0.5, 0).rotate(-M_PI / 2, 0, 0,
+                                      t::EulerRotationOrder::Xyz);
+  auto front = t::Mesh(box, shinyMaterial);
+  front.translate(-0.2, -0.2, 0.3).rotate(0.3, 0.5, 0,
+                                          t::EulerRotationOrder::Xyz);
+  auto back = t::Mesh(box, normalMaterial);
+  back.translate(0.3, 0, -0.4).rotate(0, -0.4, 0.2,
+                                      t::EulerRotationOrder::Xyz);
+  auto ambient = t::AmbientLight(t::Color(64, 64, 64), 1);
+  auto keyLight = t::PointLight(t::Color(255, 255, 255), 1);
+  keyLight.translate(1, 1.5, 1.5);
+  auto fillLight = t::PointLight(t::Color(255, 128, 0), 0.5);
+  fillLight.translate(-1.5, 0.5, 0);
+  auto camera = t::PerspectiveCamera(M_PI / 4, double(width) / height, 0.1,
+                                     100);
+  camera.translate(0, 0.3, 2);
+
+  auto scene = t::Scene();
+  scene.add(ground);
+  scene.add(front);
+  scene.add(back);
+  scene.add(ambient);
+  scene.add(keyLight);
+  scene.add(fillLight);
+  scene.add(camera);
+
+  auto renderer = t::Rasterizer();
+  configure(renderer);
+
+  return render(renderer, scene, camera);
+}
+
+/**
+ * The Cornell box: a box of colored walls, with 2 boxes inside, lit from the
+ * ceiling.
+ */
+struct CornellBox {
+  t::Plane plane = t::Plane(1, 1);
+  t::Box box = t::Box(0.3, 0.3, 0.3);
+  t::BlinnPhong redMaterial =
+      t::BlinnPhong(t::Color(180, 0, 0), t::Color(0, 0, 0), 0);
+  t::BlinnPhong greenMaterial =
+      t::BlinnPhong(t::Color(0, 180, 0), t::Color(0, 0, 0), 0);
+  t::BlinnPhong whiteMaterial =
+      t::BlinnPhong(t::Color(180, 180, 180), t::Color(0, 0, 0), 0);
+  t::Mesh leftWall = t::Mesh(plane, redMaterial);
+  t::Mesh rightWall = t::Mesh(plane, greenMaterial);
+  t::Mesh backWall = t::Mesh(plane, whiteMaterial);
+  t::Mesh ground = t::Mesh(plane, whiteMaterial);
+  t::Mesh ceiling = t::Mesh(plane, whiteMaterial);
+  t::Mesh tallBox = t::Mesh(box, whiteMaterial);
+  t::Mesh shortBox = t::Mesh(box, whiteMaterial);
+  t::AmbientLight ambient = t::AmbientLight(t::Color(64, 64, 64), 1);
+  t::PointLight light = t::PointLight(t::Color(255, 255, 255), 1);
+  t::PerspectiveCamera camera =
+      t::PerspectiveCamera(M_PI / 4, double(width) / height, 0.01, 100);
+  t::Scene scene;
+
+  CornellBox() {
+    const auto order = t::EulerRotationOrder::Xyz;
+
+    leftWall.translate(-0.5, 0, 0).rotate(0, M_PI / 2, 0, order);
+    rightWall.translate(0.5, 0, 0).rotate(0, -M_PI / 2, 0, order);
+    backWall.translate(0, 0, -0.5);
+    ground.translate(0, -0.5, 0).rotate(-M_PI / 2, 0, 0, order);
+    ceiling.translate(0, 0.5, 0).rotate(M_PI / 2, 0, 0, order);
+    tallBox.translate(-0.25, -0.2, -0.25).scale(1, 2, 1);
+    tallBox.rotate(0, M_PI / 10, 0, order);
+    shortBox.translate(0.2, -0.35, 0.25).rotate(0, -M_PI / 10, 0, order);
+    light.translate(0, 0.4, 0);
+    // Off center, so that no pixel center lies exactly on the edges where the
+    // walls meet, which may round either way
+    camera.translate(0.01, 0.02, 1);
+
+    for (t::Mesh *mesh : meshes()) {
+      scene.add(*mesh);
+    }
+
+    scene.add(ambient);
+    scene.add(light);
+    scene.add(camera);
+  }
+
+  std::vector<t::Mesh *> meshes() {
+    return {&leftWall, &rightWall, &backWall, &ground,
+            &ceiling,  &tallBox,   &shortBox};
+  }
+
+  void setStatic(bool isStatic) {
+    for (t::Mesh *mesh : meshes()) {
+      mesh->isStatic = isStatic;
+    }
+  }
+};
+
+int differentValueCount(const std::vector<double> &a,
+                        const std::vector<double> &b) {
+  int count = 0;
+
+  for (std::size_t i = 0; i < a.size(); i++) {
+    count += a[i] != b[i];
+  }
+
+  return count;
+}
+
+double maxDifference(const std::vector<double> &a,
+                     const std::vector<double> &b) {
+  double difference = 0;
+
+  for (std::size_t i = 0; i < a.size(); i++) {
+    difference = std::max(difference, std::abs(a[i] - b[i]));
+  }
+
+  return difference;
+}
+
+int coveredPixelCount(const std::vector<double> &image) {
+  int count = 0;
+
+  for (std::size_t i = 0; i < image.size(); i += 3) {
+    count += image[i] != 0 || image[i + 1] != 0 || image[i + 2] != 0;
+  }
+
+  return count;
+}
+
+} // namespace
+
+TEST(RasterizerTests, ThreadCount) {
+  for (auto shadingMode : {t::ShadingMode::Forward, t::ShadingMode::Deferred}) {
+    const auto expected = renderScene([&](t::Rasterizer &renderer) {
+      renderer.shadingMode = shadingMode;
+      renderer.threadCount = 1;
+    });
+    const auto actual = renderScene([&](t::Rasterizer &renderer) {
+      renderer.shadingMode = shadingMode;
+      renderer.threadCount = 4;
+    });
+
+    ASSERT_EQ(actual.size(), expected.size());
+    EXPECT_GT(coveredPixelCount(expected), width * height / 2);
+    EXPECT_EQ(differentValueCount(actual, expected), 0);
+  }
+}
+
+TEST(RasterizerTests, InstructionSets) {
+  const auto instructionSets = {t::InstructionSet::Scalar,
+                                t::InstructionSet::Sse41,
+                                t::InstructionSet::Avx2};
+
+  for (int threadCount : {1, 4}) {
+    const auto expected = renderScene([&](t::Rasterizer &renderer) {
+      renderer.threadCount = threadCount;
+      renderer.instructionSet = t::InstructionSet::Scalar;
+    });
+
+    for (auto instructionSet : instructionSets) {
+      // The unsupported instruction sets would fall back to a supported one
+      if (instructionSet > t::supportedInstructionSet()) {
+        continue;
+      }
+
+      const auto actual = renderScene([&](t::Rasterizer &renderer) {
+        renderer.threadCount = threadCount;
+        renderer.instructionSet = instructionSet;
+      });
+
+      ASSERT_EQ(actual.size(), expected.size());
+      EXPECT_EQ(differentValueCount(actual, expected), 0)
+          << "instruction set " << static_cast<int>(instructionSet)
+          << ", thread count " << threadCount;
+    }
+  }
+}
+
+TEST(RasterizerTests, StaticBatching) {
+  auto cornellBox = CornellBox();
+  auto renderer = t::Rasterizer();
+  const auto expected = render(renderer, cornellBox.scene, cornellBox.camera);
+
+  EXPECT_EQ(renderer.stats.drawCalls, 7);
+  EXPECT_EQ(renderer.staticBatcher.batchCount(), 0);
+
+  // The 5 white meshes are merged into 1. Their vertices are transformed to
+  // world space ahead of time, which only changes the rounding of the colors.
+  cornellBox.setStatic(true);
+  const auto actual = render(renderer, cornellBox.scene, cornellBox.camera);
+
+  EXPECT_EQ(renderer.stats.drawCalls, 3);
+  EXPECT_EQ(renderer.staticBatcher.batchCount(), 1);
+  EXPECT_GT(coveredPixelCount(expected), width * height / 3);
+  EXPECT_LT(maxDifference(actual, expected), 1e-12);
+
+  // Materials that depend on the local space are not batched
+  auto normalMaterial = t::NormalColor();
+  auto first = t::Mesh(cornellBox.box, normalMaterial);
+  auto second = t::Mesh(cornellBox.box, normalMaterial);
+  first.translate(0.2, 0.2, -0.2).rotate(0.3, 0.5, 0,
+                                         t::EulerRotationOrder::Xyz);
+  second.translate(-0.2, 0.25, 0.1);
+  first.isStatic = true;
+  second.isStatic = true;
+  cornellBox.scene.add(first).add(second);
+  const auto batchedImage =
+      render(renderer, cornellBox.scene, cornellBox.camera);
+
+  EXPECT_EQ(renderer.stats.drawCalls, 5);
+  EXPECT_EQ(renderer.staticBatcher.batchCount(), 1);
+
+  cornellBox.setStatic(false);
+  first.isStatic = false;
+  second.isStatic = false;
+  const auto unbatchedImage =
+      render(renderer, cornellBox.scene, cornellBox.camera);
+
+  EXPECT_LT(maxDifference(batchedImage, unbatchedImage), 1e-12);
+}
+
+TEST(RasterizerTests, MovingStaticMesh) {
+  auto cornellBox = CornellBox();
+  cornellBox.setStatic(true);
+  auto renderer = t::Rasterizer();
+  const auto image = render(renderer, cornellBox.scene, cornellBox.camera);
+
+  cornellBox.shortBox.translate(-0.1, 0, 0.05);
+  const auto actual = render(renderer, cornellBox.scene, cornellBox.camera);
+
+  EXPECT_EQ(renderer.staticBatcher.batchCount(), 1);
+  EXPECT_GT(maxDifference(actual, image), 0.1);
+
+  auto unbatchedRenderer = t::Rasterizer();
+  cornellBox.setStatic(false);
+  const auto expected =
+      render(unbatchedRenderer, cornellBox.scene, cornellBox.camera);
+
+  EXPECT_LT(maxDifference(actual, expected), 1e-12);
+
+  // Changing the occluder flag of a mesh takes it out of its batch
+  cornellBox.setStatic(true);
+  cornellBox.tallBox.occluder = true;
+  render(renderer, cornellBox.scene, cornellBox.camera);
+
+  EXPECT_EQ(renderer.staticBatcher.batchCount(), 1);
+  EXPECT_EQ(renderer.stats.drawCalls, 4);
+}
+
+TEST(RasterizerTests, OcclusionCulling) {
+  auto plane = t::Plane(2, 2);
+  auto box = t::Box(0.3, 0.3, 0.3);
+  auto material = t::BlinnPhong(t::Color(180, 180, 180), t::Color(0, 0, 0), 0);
+  auto wall = t::Mesh(plane, material);
+  wall.occluder = true;
+  auto hiddenBox = t::Mesh(box, material);
+  hiddenBox.translate(0, 0, -1);
+  auto visibleBox = t::Mesh(box, material);
+  visibleBox.translate(0.8, 0, 0.2);
+  auto ambient = t::AmbientLight(t::Color(64, 64, 64), 1);
+  auto light = t::PointLight(t::Color(255, 255, 255), 1);
+  light.translate(0, 1, 2);
+  auto camera = t::PerspectiveCamera(M_PI / 4, double(width) / height, 0.1,
+                                     100);
+  camera.translate(0, 0, 2);
+  auto scene = t::Scene();
+  scene.add(wall).add(hiddenBox).add(visibleBox);
+  scene.add(ambient).add(light).add(camera);
+  auto sceneBvh = t::SceneBvh(scene);
+
+  for (bool useSceneBvh : {false, true}) {
+    for (int threadCount : {1, 4}) {
+      const auto renderWith = [&](bool occlusionCulling) {
+        auto renderer = t::Rasterizer();
+        renderer.threadCount = threadCount;
+        renderer.occlusionCulling = occlusionCulling;
+        auto image = useSceneBvh ? render(renderer, sceneBvh, camera)
+                                 : render(renderer, scene, camera);
+
+        EXPECT_EQ(renderer.stats.occludedMeshes, occlusionCulling ? 1 : 0);
+        EXPECT_EQ(renderer.stats.drawCalls, occlusionCulling ? 2 : 3);
+
+        return image;
+      };
+
+      const auto expected = renderWith(false);
+      const auto actual = renderWith(true);
+
+      EXPECT_GT(coveredPixelCount(expected), width * height / 10);
+      EXPECT_EQ(differentValueCount(actual, expected), 0)
+          << "BVH " << useSceneBvh << ", thread count " << threadCount;
+    }
+  }
+}
+
+TEST(RasterizerTests, SceneBvh) {
+  auto box = t::Box(0.3, 0.3, 0.3);
+  auto material = t::BlinnPhong(t::Color(180, 180, 180), t::Color(0, 0, 0), 0);
+  auto ambient = t::AmbientLight(t::Color(64, 64, 64), 1);
+  auto light = t::PointLight(t::Color(255, 255, 255), 1);
+  light.translate(0, 1, 2);
+  auto camera = t::PerspectiveCamera(M_PI / 4, double(width) / height, 0.1,
+                                     100);
+  camera.translate(0, 0, 1.2);
+  auto scene = t::Scene();
+  scene.add(ambient).add(light).add(camera);
+
+  // Enough meshes for several leaves, apart so that the order they are drawn
+  // in does not matter, and a leaf of them behind the camera
+  auto meshes = std::vector<t::Mesh>();
+  meshes.reserve(14);
+
+  for (int i = 0; i < 14; i++) {
+    auto &mesh = meshes.emplace_back(box, material);
+
+    if (i < 10) {
+      mesh.translate(0.4 * (i % 5) - 0.8, 0.4 * (i / 5) - 0.2, -0.1 * i);
+      mesh.rotate(0.1 * i, 0.2 * i, 0, t::EulerRotationOrder::Xyz);
+    } else {
+      mesh.translate(0.4 * (i - 12), 0, 4);
+    }
+
+    scene.add(mesh);
+  }
+
+  auto &outside = meshes.back();
+  auto sceneBvh = t::SceneBvh(scene);
+  auto sceneRenderer = t::Rasterizer();
+  auto sceneBvhRenderer = t::Rasterizer();
+
+  const auto expectSameImage = [&](int culledMeshes) {
+    const auto expected = render(sceneRenderer, scene, camera);
+    const auto actual = render(sceneBvhRenderer, sceneBvh, camera);
+
+    EXPECT_EQ(sceneRenderer.stats.culledMeshes, culledMeshes);
+    EXPECT_EQ(sceneBvhRenderer.stats.culledMeshes, culledMeshes);
+    EXPECT_GT(coveredPixelCount(expected), width * height / 10);
+    EXPECT_EQ(differentValueCount(actual, expected), 0);
+  };
+
+  EXPECT_EQ(sceneBvh.meshCount(), 14);
+  expectSameImage(4);
+
+  // Refitted after moving a mesh within the view, then one into it
+  meshes[3].translate(0.1, 0.5, 0.2);
+  sceneBvh.update(meshes[3]);
+  expectSameImage(4);
+
+  outside.translate(0, 0.6, -4);
+  sceneBvh.update(outside);
+  expectSameImage(3);
+
+  // Rebuilt after adding a mesh
+  auto added = t::Mesh(box, material);
+  added.translate(-0.6, -0.6, 0.5);
+  scene.add(added);
+  sceneBvh.rebuild();
+
+  EXPECT_EQ(sceneBvh.meshCount(), 15);
+  expectSameImage(3);
+}
+
+TEST(RasterizerTests, InstancedMesh) {
+  auto box = t::Box(0.3, 0.3, 0.3);
+  auto material = t::BlinnPhong(t::Color(0, 0, 200), t::Color(255, 255, 255),
+                                32);
+  auto ambient = t::AmbientLight(t::Color(64, 64, 64), 1);
+  auto light = t::PointLight(t::Color(255, 255, 255), 1);
+  light.translate(0, 1, 2);
+  auto camera = t::PerspectiveCamera(M_PI / 4, double(width) / height, 0.1,
+                                     100);
+  camera.translate(0, 0, 1.2);
+
+  // The same boxes as separate meshes, then as the instances of one mesh
+  constexpr int count = 5;
+  auto meshes = std::vector<t::Mesh>();
+  meshes.reserve(count);
+  auto separateScene = t::Scene();
+  separateScene.add(ambient).add(light).add(camera);
+
+  for (int i = 0; i < count; i++) {
+    auto &mesh = meshes.emplace_back(box, material);
+    mesh.translate(0.4 * i - 0.8, 0.1 * i - 0.2, -0.2 * i);
+    mesh.rotate(0.3 * i, 0.5, 0, t::EulerRotationOrder::Xyz);
+    mesh.scale(1, 1 + 0.2 * i, 1);
+    separateScene.add(mesh);
+  }
+
+  auto renderer = t::Rasterizer();
+  const auto expected = render(renderer, separateScene, camera);
+
+  EXPECT_EQ(renderer.stats.drawCalls, count);
+
+  auto instanceMatrices = std::vector<t::Matrix4x4>();
+
+  for (auto &mesh : meshes) {
+    instanceMatrices.push_back(mesh.modelMatrix);
+  }
+
+  auto instancedMesh = t::InstancedMesh(box, material, instanceMatrices);
+  auto instancedScene = t::Scene();
+  instancedScene.add(instancedMesh).add(ambient).add(light).add(camera);
+  const auto actual = render(renderer, instancedScene, camera);
+
+  EXPECT_EQ(renderer.stats.drawCalls, 1);
+  EXPECT_GT(coveredPixelCount(expected), width * height / 20);
+  EXPECT_EQ(differentValueCount(actual, expected), 0);
+}
+
+TEST(RasterizerTests, NearAndFarClipping) {
+  // A ground plane under a level camera, which extends behind the camera
+  // across the near plane and far beyond the guard band on the sides
+  constexpr double fov = M_PI / 4;
+  constexpr double cameraHeight = 0.5;
+  auto plane = t::Plane(200, 200);
+  auto material = t::SolidColor(t::Color(255, 255, 255));
+  auto ground = t::Mesh(plane, material);
+  ground.translate(0, -cameraHeight, 0).rotate(-M_PI / 2, 0, 0,
+                                               t::EulerRotationOrder::Xyz);
+
+  for (auto [near, far] : {std::pair{0.1, 5.0}, std::pair{2.0, 20.0}}) {
+    auto camera = t::PerspectiveCamera(fov, double(width) / height, near, far);
+    camera.translate(0, 0, 1);
+    auto scene = t::Scene();
+    scene.add(ground).add(camera);
+
+    auto renderer = t::Rasterizer();
+    const auto expected = render(renderer, scene, camera);
+
+    // A row is covered if the ray through its pixel centers hits the ground
+    // between the near and far planes. The rows go from the top down.
+    for (int y = 0; y < height; y++) {
+      const auto ndcY = 1 - (y + 0.5) / (height / 2.0);
+      const auto depth = cameraHeight / (-ndcY * std::tan(fov / 2));
+      int coveredCount = 0;
+
+      for (int x = 0; x < width; x++) {
+        coveredCount += expected[(x + y * width) * 3] != 0;
+      }
+
+      EXPECT_EQ(coveredCount,
+                ndcY < 0 && depth >= near && depth <= far ? width : 0)
+          << "row " << y << ", near " << near << ", far " << far;
+    }
+
+    renderer.threadCount = 4;
+    const auto actual = render(renderer, scene, camera);
+
+    EXPECT_EQ(differentValueCount(actual, expected), 0);
+  }
+}